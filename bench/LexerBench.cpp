@@ -0,0 +1,114 @@
+#include "lexer/FastLexer.h"
+#include "lexer/FastTokenSource.h"
+#include "pipeline/input/MappedCharStream.h"
+#include "TinyCLexer.h"
+
+// Lexes one large generated source with TinyCLexer and with FastLexer and reports the tokens per second of both.
+// Before timing, the tokens of both lexers are compared, so the benchmark also fails when they disagree.
+//
+// usage: lexer_bench [function count]
+
+static std::string generateSource(size_t functions)
+{
+    std::string source = "struct Node { int value; struct Node* next; int data[16]; };\n\n";
+    for (size_t i = 0; i < functions; i++) {
+        source += fmt::format(
+                "int function{0}(int count, struct Node* node, int* values)\n"
+                "{{\n"
+                "    int sum = {0};\n"
+                "    int i;\n"
+                "    for (i = 0; i < count; i = i + 1) {{\n"
+                "        if (values[i] >= 0) {{\n"
+                "            sum = sum + values[i] * 3 - node->data[i / 2];\n"
+                "        }} else {{\n"
+                "            sum = sum - *values;\n"
+                "        }}\n"
+                "    }}\n"
+                "    while (node->next != 0) node = node->next;\n"
+                "    return (sum <= 1000000) + (node->value != {0});\n"
+                "}}\n\n",
+                i);
+    }
+    return source;
+}
+
+static std::unique_ptr<MappedCharStream> makeInput(const std::string& source)
+{
+    return std::make_unique<MappedCharStream>(llvm::MemoryBuffer::getMemBuffer(source, "bench", false));
+}
+
+static bool compareTokens(const std::string& source)
+{
+    auto antlrInput = makeInput(source);
+    TinyCLexer antlrLexer{antlrInput.get()};
+
+    auto fastInput = makeInput(source);
+    FastLexer fastLexer{fastInput->getBuffer()};
+    auto tokens = fastLexer.tokenize();
+    if (fastLexer.hasErrors()) {
+        TC_LOG_ERROR("FastLexer reported errors");
+        return false;
+    }
+    FastTokenSource fastSource{std::move(tokens), fastInput.get()};
+
+    for (size_t i = 0;; i++) {
+        auto expected = antlrLexer.nextToken();
+        auto actual = fastSource.nextToken();
+        if (expected->getType() != actual->getType() || expected->getLine() != actual->getLine()
+            || expected->getCharPositionInLine() != actual->getCharPositionInLine() || expected->getText() != actual->getText()) {
+            TC_LOG_ERROR("token {} differs -- TinyCLexer: {}, FastLexer: {}", i, expected->toString(), actual->toString());
+            return false;
+        }
+        if (expected->getType() == antlr4::Token::EOF) {
+            return true;
+        }
+    }
+}
+
+// best of a few runs, the first one also pays for cold caches and page faults
+template<typename F>
+static double measureSeconds(F&& function)
+{
+    double best = 0;
+    for (int run = 0; run < 5; run++) {
+        auto start = std::chrono::steady_clock::now();
+        function();
+        std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+        if (run == 0 || elapsed.count() < best) {
+            best = elapsed.count();
+        }
+    }
+    return best;
+}
+
+int main(int argc, char** argv)
+{
+    logInit();
+
+    size_t functions = argc > 1 ? std::strtoul(argv[1], nullptr, 10) : 20000;
+    auto source = generateSource(functions);
+
+    if (!compareTokens(source)) {
+        return EXIT_FAILURE;
+    }
+
+    size_t tokenCount = 0;
+    auto antlrSeconds = measureSeconds([&] {
+        auto input = makeInput(source);
+        TinyCLexer lexer{input.get()};
+        tokenCount = 0;
+        while (lexer.nextToken()->getType() != antlr4::Token::EOF) {
+            tokenCount++;
+        }
+    });
+    auto fastSeconds = measureSeconds([&] {
+        FastLexer lexer{source};
+        TC_UNUSED(lexer.tokenize());
+    });
+
+    std::cout << fmt::format("{} tokens, {:.1f} MB\n", tokenCount, source.size() / 1e6);
+    std::cout << fmt::format("TinyCLexer {:>14.0f} tokens/s\n", tokenCount / antlrSeconds);
+    std::cout << fmt::format("FastLexer  {:>14.0f} tokens/s  {:.1f}x\n", tokenCount / fastSeconds, antlrSeconds / fastSeconds);
+
+    return EXIT_SUCCESS;
+}
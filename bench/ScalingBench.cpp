@@ -0,0 +1,188 @@
+#include "asg/AsgArena.h"
+#include "asg/AsgNode.h"
+#include "ast/AstVisitor.h"
+#include "pipeline/input/FileReader.h"
+#include "pipeline/input/SourceParser.h"
+
+// Builds the ASG of generated programs of growing nesting depth and statement count, with AstVisitor and with
+// --parser=rd. Every doubling of the input may at most double the ASG arena bytes, with some slack; anything worse
+// fails the benchmark. Times are printed, they are only checked the same way with --check-time, as wall clock ratios
+// of a loaded machine are too noisy for the test run.
+//
+// usage: scaling_bench [--check-time]
+
+// functions per nesting program, so that even the smallest depth takes long enough to be timed
+static constexpr size_t nest_copies = 64;
+
+static constexpr size_t runs = 5;
+
+// the allowed growth per doubling of the input
+static constexpr double max_time_ratio = 3.0;
+static constexpr double max_bytes_ratio = 2.5;
+
+// shorter times are mostly timer and scheduling noise, they are compared as if they took this long
+static constexpr double min_compared_seconds = 1e-3;
+
+struct Measurement {
+    double seconds = 0;
+    size_t bytes = 0;
+};
+
+// every level is one of while, if-else, for and a plain block, with a statement before the next level
+static std::string generateNested(size_t depth)
+{
+    std::string source;
+    for (size_t copy = 0; copy < nest_copies; copy++) {
+        std::string closing;
+        source += fmt::format("int nest{}(int x)\n{{\n", copy);
+        for (size_t level = 0; level < depth; level++) {
+            source += "x = x + 1;\n";
+            switch (level % 4) {
+            case 0:
+                source += "while (x < 1000) {\n";
+                closing = "}\n" + closing;
+                break;
+            case 1:
+                source += "if (x > 3) {\n";
+                closing = "} else {\nx = 0;\n}\n" + closing;
+                break;
+            case 2:
+                source += "for (x = 0; x < 10; x = x + 1) {\n";
+                closing = "}\n" + closing;
+                break;
+            default:
+                source += "{\n";
+                closing = "}\n" + closing;
+                break;
+            }
+        }
+        source += "x = x * 2;\n" + closing + "return x;\n}\n\n";
+    }
+    return source;
+}
+
+static std::string generateFlat(size_t statements)
+{
+    std::string source = "int flat(int x)\n{\n";
+    for (size_t i = 0; i < statements; i++) {
+        source += fmt::format("int v{0} = x * {0};\nx = x + v{0} / 2;\n", i);
+    }
+    source += "return x;\n}\n";
+    return source;
+}
+
+static std::any buildWithAntlr(const std::string& file, double& seconds)
+{
+    auto unit = FileReader{file, true}.produce();
+    if (!unit.has_value()) {
+        return {};
+    }
+
+    // parsing is not timed, only the tree construction
+    AstVisitor visitor;
+    auto start = std::chrono::steady_clock::now();
+    auto root = visitor.modify(std::move(unit));
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return root;
+}
+
+static std::any buildWithRd(const std::string& file, double& seconds)
+{
+    auto start = std::chrono::steady_clock::now();
+    auto root = SourceParser{file, 1}.produce();
+    seconds = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+    return root;
+}
+
+using BuildFunction = std::any (*)(const std::string& file, double& seconds);
+
+// best time of a few runs, each builds the tree in a fresh arena
+static std::optional<Measurement> measure(BuildFunction build, const std::string& file)
+{
+    Measurement best;
+    for (size_t run = 0; run < runs; run++) {
+        AsgArena arena;
+        AsgArena::Scope arenaScope{arena};
+
+        double seconds = 0;
+        auto root = build(file, seconds);
+        if (!root.has_value()) {
+            return std::nullopt;
+        }
+        std::unique_ptr<AsgNode> tree{std::any_cast<AsgNode*>(root)};
+
+        if (run == 0 || seconds < best.seconds) {
+            best.seconds = seconds;
+        }
+        best.bytes = arena.getBytesAllocated();
+    }
+    return best;
+}
+
+static bool writeTemporary(const std::string& source, llvm::SmallVectorImpl<char>& path)
+{
+    int fd;
+    if (auto error = llvm::sys::fs::createTemporaryFile("scaling_bench", "c", fd, path)) {
+        TC_LOG_CRITICAL("can not create temporary file -- {}", error.message());
+        return false;
+    }
+    llvm::raw_fd_ostream stream{fd, true};
+    stream << source;
+    return true;
+}
+
+// sizes double from one step to the next
+static bool runSeries(std::string_view frontEnd, BuildFunction build, std::string_view series, std::string (*generate)(size_t), llvm::ArrayRef<size_t> sizes, bool checkTime)
+{
+    auto ok = true;
+    std::optional<Measurement> previous;
+    for (auto size : sizes) {
+        llvm::SmallString<128> path;
+        if (!writeTemporary(generate(size), path)) {
+            return false;
+        }
+        llvm::FileRemover remover{path};
+
+        auto current = measure(build, std::string{path.str()});
+        if (!current) {
+            TC_LOG_ERROR("{} {} {} -- building the tree failed", frontEnd, series, size);
+            return false;
+        }
+
+        std::string ratios;
+        if (previous) {
+            auto timeRatio = std::max(current->seconds, min_compared_seconds) / std::max(previous->seconds, min_compared_seconds);
+            auto bytesRatio = static_cast<double>(current->bytes) / static_cast<double>(previous->bytes);
+            ratios = fmt::format("  x{:.2f} time  x{:.2f} bytes", timeRatio, bytesRatio);
+            if ((checkTime && timeRatio > max_time_ratio) || bytesRatio > max_bytes_ratio) {
+                ratios += "  -- not linear";
+                ok = false;
+            }
+        }
+        std::cout << fmt::format("{:<12}{:<8}{:>8}{:>12.3f} ms{:>12} bytes{}\n", frontEnd, series, size, current->seconds * 1000, current->bytes, ratios);
+        previous = current;
+    }
+    return ok;
+}
+
+int main(int argc, char** argv)
+{
+    logInit();
+
+    auto checkTime = argc > 1 && std::string_view{argv[1]} == "--check-time";
+
+    static constexpr size_t depths[] = {8, 16, 32, 64, 128, 256};
+    static constexpr size_t statements[] = {2000, 4000, 8000, 16000};
+
+    auto ok = true;
+    for (auto [frontEnd, build] : {std::pair{"AstVisitor", &buildWithAntlr}, std::pair{"rd", &buildWithRd}}) {
+        ok &= runSeries(frontEnd, build, "depth", &generateNested, depths, checkTime);
+        ok &= runSeries(frontEnd, build, "flat", &generateFlat, statements, checkTime);
+    }
+
+    if (!ok) {
+        TC_LOG_ERROR("tree construction does not scale linearly");
+        return EXIT_FAILURE;
+    }
+    return EXIT_SUCCESS;
+}
@@ -0,0 +1,13 @@
+int dot(int xs[], int ys[], int len)
+{
+    int sum = 0;
+    for (int i = 0; i < len; i = i + 1) {
+        sum = sum + xs[i] * ys[i];
+    }
+    return sum;
+}
+
+int square(int x)
+{
+    return x * x;
+}
@@ -0,0 +1,21 @@
+int dot(int xs[], int ys[], int len);
+int square(int x);
+
+int main()
+{
+    int xs[3];
+    {
+        xs[0] = 1;
+        xs[1] = 2;
+        xs[2] = 3;
+    }
+
+    int ys[3];
+    {
+        ys[0] = 4;
+        ys[1] = 5;
+        ys[2] = 6;
+    }
+
+    return dot(xs, ys, 3) - square(4) - 16;
+}
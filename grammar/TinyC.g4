@@ -21,7 +21,7 @@ structField
 
 
 functionDef
-    :   type functionName L_PARAN parameters? R_PARAN statements
+    :   type functionName L_PARAN parameters? R_PARAN ( statements | SEMICOLON )
     ;
 
 type
@@ -1,97 +1,49 @@
-#include "ast/AstVisitor.h"
-#include "ir/IrEmitter.h"
+#include "driver/Driver.h"
 #include "os/OsInit.h"
+#include "os/OsServer.h"
 #include "pipeline/input/FileReader.h"
-#include "pipeline/output/FileWriter.h"
-#include "pipeline/output/TerminalWriter.h"
-#include "pipeline/Pipeline.h"
-#include "symbols/SymbolResolver.h"
-#include "symbols/TypeResolver.h"
-#include "version/Version.h"
 
 int main(int argc, char** argv)
 {
-    argparse::ArgumentParser program{"tcc", getVersion()};
-
-    program.add_argument("input")
-        .help("specify the input file")
-        .required();
-
-    program.add_argument("-o", "--output")
-        .help("specify the output file")
-        .default_value(std::string{});
-
-    program.add_argument("--no-opt")
-        .help("disable optimizations")
-        .default_value(false)
-        .implicit_value(true);
-
-    program.add_argument("-p", "--print")
-        .help("print IR to stdout instead of creating output file")
-        .default_value(false)
-        .implicit_value(true);
-
-    program.add_argument("--dump")
-        .help("create crash dump on failure")
-        .default_value(false)
-        .implicit_value(true);
-
-    try {
-        program.parse_args(argc, argv);
-    } catch (const std::runtime_error& err) {
-        std::cerr << err.what() << std::endl;
-        std::cerr << program;
+    std::vector<std::string> args{argv, argv + argc};
+    auto options = parseDriverOptions(args);
+    if (!options) {
         return EXIT_FAILURE;
     }
 
-    osInit(program.get<bool>("--dump"));
+    osInit(options->dump);
     logInit();
 
-    auto inputFileName = program.get<std::string>("input");
-
-    auto moduleName = inputFileName;
-    auto lastPathChar = moduleName.find_last_of('/');
-    if (lastPathChar == std::string::npos) {
-        lastPathChar = moduleName.find_last_of('\\');
-    } else {
-        auto l = moduleName.find_last_of('\\');
-        if (l != std::string::npos && l > lastPathChar) {
-            lastPathChar = l;
+    // --run executes the program in the compiling process, which must not be the server
+    if (!options->connect.empty() && !options->run) {
+        if (auto exitCode = osForward(options->connect, args)) {
+            return *exitCode;
         }
-    }
-    if (lastPathChar != std::string::npos) {
-        moduleName.erase(0, lastPathChar + 1);
+        TC_LOG_WARN("server at {} is not reachable, compiling in process", options->connect);
     }
 
-    Pipeline pipeline;
+    llvm::InitializeAllTargetInfos();
+    llvm::InitializeAllTargets();
+    llvm::InitializeAllTargetMCs();
+    llvm::InitializeAllAsmParsers();
+    llvm::InitializeAllAsmPrinters();
 
-    pipeline
-        .add(std::make_unique<FileReader>(program.get<std::string>("input")))
-        .add(std::make_unique<AstVisitor>())
-        .add(std::make_unique<SymbolResolver>())
-        .add(std::make_unique<TypeResolver>())
-        .add(std::make_unique<IrEmitter>(moduleName, !program.get<bool>("--no-opt")));
-
-    auto outputName = program.get<std::string>("-o");
-    if (outputName.empty()) {
-        outputName = inputFileName.erase(
-                         inputFileName.find_last_of('.'),
-                         inputFileName.size())
-                   + ".ll";
-    }
-
-    if (program.get<bool>("-p")) {
-        pipeline.add(std::make_unique<TerminalWriter>());
-    } else {
-        pipeline.add(std::make_unique<FileWriter>(outputName));
+    if (!options->server.empty()) {
+        if (options->warmParser) {
+            FileReader::warmUp();
+        }
+        return osServe(options->server, [](const std::vector<std::string>& requestArgs) {
+            auto requestOptions = parseDriverOptions(requestArgs);
+            if (!requestOptions || !requestOptions->server.empty()) {
+                return EXIT_FAILURE;
+            }
+            if (requestOptions->run) {
+                TC_LOG_ERROR("--run is not supported by the server");
+                return EXIT_FAILURE;
+            }
+            return Driver{std::move(*requestOptions)}.run();
+        });
     }
 
-    if (!pipeline.run()) {
-        TC_LOG_ERROR("compilation failed due to errors");
-        return EXIT_FAILURE;
-    }
-    if (!program.get<bool>("-p")) {
-        TC_LOG_INFO("compilation finished -> {}", outputName.empty() ? "stdout" : outputName);
-    }
-    return EXIT_SUCCESS;
+    return Driver{std::move(*options)}.run();
 }
@@ -0,0 +1,51 @@
+#include "AsgArena.h"
+
+static thread_local AsgArena* current_arena = nullptr;
+
+AsgArena::Scope::Scope(AsgArena& arena)
+    : previous_(current_arena)
+{
+    current_arena = &arena;
+}
+
+AsgArena::Scope::~Scope()
+{
+    current_arena = previous_;
+}
+
+AsgArena* AsgArena::current()
+{
+    return current_arena;
+}
+
+AsgArena& AsgArena::createWorkerArena()
+{
+    std::lock_guard lock{worker_arenas_mutex_};
+    auto& worker = *worker_arenas_.emplace_back(std::make_unique<AsgArena>());
+    worker.owner_ = this;
+    return worker;
+}
+
+void* AsgArena::allocate(size_t size, size_t alignment)
+{
+    return allocator_.Allocate(size, llvm::Align(alignment));
+}
+
+size_t AsgArena::getBytesAllocated() const
+{
+    std::scoped_lock lock{worker_arenas_mutex_, identifiers_mutex_};
+    auto bytes = allocator_.getBytesAllocated() + identifier_allocator_.getBytesAllocated();
+    for (const auto& arena : worker_arenas_) {
+        bytes += arena->getBytesAllocated();
+    }
+    return bytes;
+}
+
+Identifier AsgArena::intern(llvm::StringRef name)
+{
+    if (owner_) {
+        return owner_->intern(name);
+    }
+    std::lock_guard lock{identifiers_mutex_};
+    return Identifier{identifiers_.save(name)};
+}
@@ -0,0 +1,46 @@
+#ifndef TINYC_ASGARENA_H
+#define TINYC_ASGARENA_H
+
+#include "symbols/Identifier.h"
+
+class AsgArena {
+public:
+    class Scope {
+    public:
+        explicit Scope(AsgArena& arena);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        AsgArena* previous_;
+    };
+
+    AsgArena() = default;
+    AsgArena(const AsgArena&) = delete;
+    AsgArena& operator=(const AsgArena&) = delete;
+
+    static AsgArena* current();
+
+    // arena for another thread building nodes of the same tree, it lives as long as this arena
+    AsgArena& createWorkerArena();
+
+    void* allocate(size_t size, size_t alignment);
+    size_t getBytesAllocated() const;
+
+    // worker arenas intern into the arena that created them, so identifiers stay comparable across the whole tree
+    Identifier intern(llvm::StringRef name);
+
+private:
+    llvm::BumpPtrAllocator allocator_;
+    std::vector<std::unique_ptr<AsgArena>> worker_arenas_;
+    mutable std::mutex worker_arenas_mutex_;
+
+    AsgArena* owner_ = nullptr;
+    llvm::BumpPtrAllocator identifier_allocator_;
+    llvm::UniqueStringSaver identifiers_{identifier_allocator_};
+    mutable std::mutex identifiers_mutex_;
+};
+
+#endif
@@ -1,15 +1,16 @@
 #include "AsgNode.h"
 
-void AsgNode::addLocalVar(const std::string& name, const Type::Id& type)
+#include "AsgArena.h"
+
+void* AsgNode::operator new(size_t size)
 {
-    if (list) {
-        list->addLocalVar(name, type);
-    }
+    auto* arena = AsgArena::current();
+    TC_ASSERT(arena);
+    return arena->allocate(size, alignof(std::max_align_t));
 }
 
-std::any AsgStatementList::accept(AsgVisitorBase* visitor)
+void AsgNode::operator delete(void*)
 {
-    return visitor->visitStatementList(this);
 }
 
 void AsgStatementList::updateChild(AsgNode* from, AsgNode* to)
@@ -22,25 +23,10 @@ void AsgStatementList::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-void AsgStatementList::addLocalVar(const std::string& name, const Type::Id& type)
-{
-    localVariables.insert({name, type});
-}
-
-std::any AsgStructDefinition::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitStructDefinition(this);
-}
-
 void AsgStructDefinition::updateChild(AsgNode* from, AsgNode* to)
 {
 }
 
-std::any AsgFunctionDefinition::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitFunctionDefinition(this);
-}
-
 void AsgFunctionDefinition::updateChild(AsgNode* from, AsgNode* to)
 {
     if (body.get() == from) {
@@ -49,9 +35,10 @@ void AsgFunctionDefinition::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgVariableDefinition::accept(AsgVisitorBase* visitor)
+size_t AsgFunctionDefinition::addSlot(Type::Id type)
 {
-    return visitor->visitVariableDefinition(this);
+    slots.push_back(type);
+    return slots.size() - 1;
 }
 
 void AsgVariableDefinition::updateChild(AsgNode* from, AsgNode* to)
@@ -62,11 +49,6 @@ void AsgVariableDefinition::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgReturn::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitReturn(this);
-}
-
 void AsgReturn::updateChild(AsgNode* from, AsgNode* to)
 {
     if (value.get() == from) {
@@ -75,11 +57,6 @@ void AsgReturn::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgAssignment::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitAssignment(this);
-}
-
 void AsgAssignment::updateChild(AsgNode* from, AsgNode* to)
 {
     if (assignable.get() == from) {
@@ -91,11 +68,6 @@ void AsgAssignment::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgConditional::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitConditional(this);
-}
-
 void AsgConditional::updateChild(AsgNode* from, AsgNode* to)
 {
     if (condition.get() == from) {
@@ -110,11 +82,6 @@ void AsgConditional::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgLoop::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitLoop(this);
-}
-
 void AsgLoop::updateChild(AsgNode* from, AsgNode* to)
 {
     if (condition.get() == from) {
@@ -126,11 +93,6 @@ void AsgLoop::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgComp::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitComp(this);
-}
-
 void AsgComp::updateChild(AsgNode* from, AsgNode* to)
 {
     if (lhs.get() == from) {
@@ -142,11 +104,6 @@ void AsgComp::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgAddSub::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitAddSub(this);
-}
-
 void AsgAddSub::updateChild(AsgNode* from, AsgNode* to)
 {
     for (auto& s : subexpressions) {
@@ -157,11 +114,6 @@ void AsgAddSub::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgMulDiv::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitMulDiv(this);
-}
-
 void AsgMulDiv::updateChild(AsgNode* from, AsgNode* to)
 {
     for (auto& s : subexpressions) {
@@ -172,11 +124,6 @@ void AsgMulDiv::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgFieldAccess::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitFieldAccess(this);
-}
-
 void AsgFieldAccess::updateChild(AsgNode* from, AsgNode* to)
 {
     if (accessed.get() == from) {
@@ -185,11 +132,6 @@ void AsgFieldAccess::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgIndexing::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitIndexing(this);
-}
-
 void AsgIndexing::updateChild(AsgNode* from, AsgNode* to)
 {
     if (indexed.get() == from) {
@@ -205,11 +147,6 @@ void AsgIndexing::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgOpDeref::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitOpDeref(this);
-}
-
 void AsgOpDeref::updateChild(AsgNode* from, AsgNode* to)
 {
     if (expression.get() == from) {
@@ -218,11 +155,6 @@ void AsgOpDeref::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgOpRef::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitOpRef(this);
-}
-
 void AsgOpRef::updateChild(AsgNode* from, AsgNode* to)
 {
     if (value.get() == from) {
@@ -231,20 +163,10 @@ void AsgOpRef::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgVariable::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitVariable(this);
-}
-
 void AsgVariable::updateChild(AsgNode* from, AsgNode* to)
 {
 }
 
-std::any AsgCall::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitCall(this);
-}
-
 void AsgCall::updateChild(AsgNode* from, AsgNode* to)
 {
     for (auto& a : arguments) {
@@ -255,11 +177,6 @@ void AsgCall::updateChild(AsgNode* from, AsgNode* to)
     }
 }
 
-std::any AsgIntLiteral::accept(AsgVisitorBase* visitor)
-{
-    return visitor->visitIntLiteral(this);
-}
-
 void AsgIntLiteral::updateChild(AsgNode* from, AsgNode* to)
 {
 }
@@ -1,19 +1,66 @@
 #ifndef TINYC_ASGNODE_H
 #define TINYC_ASGNODE_H
 
-#include "AsgVisitor.h"
 #include "symbols/Function.h"
+#include "symbols/Identifier.h"
 #include "symbols/Type.h"
+#include "symbols/TypeRef.h"
 #include "utils/Defs.h"
 
+#define DECL_ASG_KIND(k)                 \
+    static AsgNode::Kind getKindStatic() \
+    {                                    \
+        return AsgNode::Kind::k;         \
+    }                                    \
+    Asg##k()                             \
+        : AsgNode(AsgNode::Kind::k)      \
+    {                                    \
+    }
+
 struct AsgNode {
+    enum class Kind {
+        StatementList,
+        StructDefinition,
+        FunctionDefinition,
+        VariableDefinition,
+        Return,
+        Assignment,
+        Conditional,
+        Loop,
+        Comp,
+        AddSub,
+        MulDiv,
+        FieldAccess,
+        Indexing,
+        OpDeref,
+        OpRef,
+        Variable,
+        Call,
+        IntLiteral
+    };
+
+    explicit AsgNode(Kind kind)
+        : kind(kind)
+    {
+    }
+
     virtual ~AsgNode() = default;
 
-    virtual std::any accept(AsgVisitorBase* visitor) = 0;
+    static void* operator new(size_t size);
+    static void operator delete(void* ptr);
+
     virtual void updateChild(AsgNode* from, AsgNode* to) = 0;
 
-    virtual void addLocalVar(const std::string& name, const Type::Id& type);
+    template<typename T>
+    T* as()
+    {
+        if (kind == T::getKindStatic()) {
+            return static_cast<T*>(this);
+        }
+        return nullptr;
+    }
 
+    const Kind kind;
     AsgNode* parent = nullptr;
 
     struct AsgStatementList* list = nullptr;
@@ -23,64 +70,72 @@ struct AsgNode {
 };
 
 struct AsgStatementList : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
-    void updateChild(AsgNode* from, AsgNode* to) override;
+    DECL_ASG_KIND(StatementList)
 
-    void addLocalVar(const std::string& name, const Type::Id& type) override;
+    void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::vector<std::unique_ptr<AsgNode>> statements;
-    std::unordered_map<std::string, Type::Id> localVariables;
 };
 
 struct AsgStructDefinition : AsgNode {
+    DECL_ASG_KIND(StructDefinition)
+
     struct Field {
-        std::string type;
-        std::string name;
+        TypeRef type;
+        Identifier name;
         size_t refLine;
     };
 
-    std::any accept(AsgVisitorBase* visitor) override;
     void updateChild(AsgNode* from, AsgNode* to) override;
 
-    std::string name;
+    Identifier name;
     std::vector<Field> fields;
 };
 
 struct AsgFunctionDefinition : AsgNode {
+    DECL_ASG_KIND(FunctionDefinition)
+
     struct Parameter {
-        std::string type;
-        std::string name;
+        TypeRef type;
+        Identifier name;
+        size_t slot = 0;
     };
 
-    std::any accept(AsgVisitorBase* visitor) override;
     void updateChild(AsgNode* from, AsgNode* to) override;
 
-    std::string name;
-    std::string returnType;
+    size_t addSlot(Type::Id type);
+
+    Identifier name;
+    TypeRef returnType;
     std::vector<Parameter> parameters;
     std::unique_ptr<AsgNode> body;
 
     FunctionId type = nullptr;
+    std::vector<Type::Id> slots;
 };
 
 struct AsgVariableDefinition : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(VariableDefinition)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
-    std::string type;
-    std::string name;
+    TypeRef type;
+    Identifier name;
+    size_t slot = 0;
     std::unique_ptr<AsgNode> value;
 };
 
 struct AsgReturn : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Return)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> value;
 };
 
 struct AsgAssignment : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Assignment)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> assignable;
@@ -88,7 +143,8 @@ struct AsgAssignment : AsgNode {
 };
 
 struct AsgConditional : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Conditional)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> condition;
@@ -97,7 +153,8 @@ struct AsgConditional : AsgNode {
 };
 
 struct AsgLoop : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Loop)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> condition;
@@ -105,6 +162,8 @@ struct AsgLoop : AsgNode {
 };
 
 struct AsgComp : AsgNode {
+    DECL_ASG_KIND(Comp)
+
     enum class Operator {
         Equals,
         NotEquals,
@@ -114,7 +173,6 @@ struct AsgComp : AsgNode {
         GreaterEquals
     };
 
-    std::any accept(AsgVisitorBase* visitor) override;
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> lhs;
@@ -123,6 +181,8 @@ struct AsgComp : AsgNode {
 };
 
 struct AsgAddSub : AsgNode {
+    DECL_ASG_KIND(AddSub)
+
     enum class Operator {
         Add,
         Sub
@@ -133,13 +193,14 @@ struct AsgAddSub : AsgNode {
         std::unique_ptr<AsgNode> expression;
     };
 
-    std::any accept(AsgVisitorBase* visitor) override;
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::vector<Subexpression> subexpressions;
 };
 
 struct AsgMulDiv : AsgNode {
+    DECL_ASG_KIND(MulDiv)
+
     enum class Operator {
         Mul,
         Div
@@ -150,22 +211,23 @@ struct AsgMulDiv : AsgNode {
         std::unique_ptr<AsgNode> expression;
     };
 
-    std::any accept(AsgVisitorBase* visitor) override;
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::vector<Subexpression> subexpressions;
 };
 
 struct AsgFieldAccess : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(FieldAccess)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
-    std::string field;
+    Identifier field;
     std::unique_ptr<AsgNode> accessed;
 };
 
 struct AsgIndexing : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Indexing)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> indexed;
@@ -173,7 +235,8 @@ struct AsgIndexing : AsgNode {
 };
 
 struct AsgOpDeref : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(OpDeref)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     size_t derefCount;
@@ -181,33 +244,40 @@ struct AsgOpDeref : AsgNode {
 };
 
 struct AsgOpRef : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(OpRef)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     std::unique_ptr<AsgNode> value;
 };
 
 struct AsgVariable : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Variable)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
-    std::string name;
+    Identifier name;
+    size_t slot = 0;
 };
 
 struct AsgCall : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(Call)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
-    std::string functionName;
+    Identifier functionName;
     FunctionId callee;
     std::vector<std::unique_ptr<AsgNode>> arguments;
 };
 
 struct AsgIntLiteral : AsgNode {
-    std::any accept(AsgVisitorBase* visitor) override;
+    DECL_ASG_KIND(IntLiteral)
+
     void updateChild(AsgNode* from, AsgNode* to) override;
 
     int value;
 };
 
+#undef DECL_ASG_KIND
+
 #endif
@@ -1,26 +1,60 @@
 #ifndef TINYC_ASGVISITOR_H
 #define TINYC_ASGVISITOR_H
 
-struct AsgVisitorBase {
-    virtual std::any visitStatementList(struct AsgStatementList* node) = 0;
-    virtual std::any visitStructDefinition(struct AsgStructDefinition* node) = 0;
-    virtual std::any visitFunctionDefinition(struct AsgFunctionDefinition* node) = 0;
-    virtual std::any visitVariableDefinition(struct AsgVariableDefinition* node) = 0;
-    virtual std::any visitReturn(struct AsgReturn* node) = 0;
-    virtual std::any visitAssignment(struct AsgAssignment* node) = 0;
-    virtual std::any visitConditional(struct AsgConditional* node) = 0;
-    virtual std::any visitLoop(struct AsgLoop* node) = 0;
+#include "AsgNode.h"
 
-    virtual std::any visitComp(struct AsgComp* node) = 0;
-    virtual std::any visitAddSub(struct AsgAddSub* node) = 0;
-    virtual std::any visitMulDiv(struct AsgMulDiv* node) = 0;
-    virtual std::any visitFieldAccess(struct AsgFieldAccess* node) = 0;
-    virtual std::any visitIndexing(struct AsgIndexing* node) = 0;
-    virtual std::any visitOpDeref(struct AsgOpDeref* node) = 0;
-    virtual std::any visitOpRef(struct AsgOpRef* node) = 0;
-    virtual std::any visitVariable(struct AsgVariable* node) = 0;
-    virtual std::any visitCall(struct AsgCall* node) = 0;
-    virtual std::any visitIntLiteral(struct AsgIntLiteral* node) = 0;
+template<typename Derived, typename R>
+class AsgVisitor {
+protected:
+    R visit(AsgNode* node)
+    {
+        auto* self = static_cast<Derived*>(this);
+        switch (node->kind) {
+        case AsgNode::Kind::StatementList:
+            return self->visitStatementList(static_cast<AsgStatementList*>(node));
+        case AsgNode::Kind::StructDefinition:
+            return self->visitStructDefinition(static_cast<AsgStructDefinition*>(node));
+        case AsgNode::Kind::FunctionDefinition:
+            return self->visitFunctionDefinition(static_cast<AsgFunctionDefinition*>(node));
+        case AsgNode::Kind::VariableDefinition:
+            return self->visitVariableDefinition(static_cast<AsgVariableDefinition*>(node));
+        case AsgNode::Kind::Return:
+            return self->visitReturn(static_cast<AsgReturn*>(node));
+        case AsgNode::Kind::Assignment:
+            return self->visitAssignment(static_cast<AsgAssignment*>(node));
+        case AsgNode::Kind::Conditional:
+            return self->visitConditional(static_cast<AsgConditional*>(node));
+        case AsgNode::Kind::Loop:
+            return self->visitLoop(static_cast<AsgLoop*>(node));
+        case AsgNode::Kind::Comp:
+            return self->visitComp(static_cast<AsgComp*>(node));
+        case AsgNode::Kind::AddSub:
+            return self->visitAddSub(static_cast<AsgAddSub*>(node));
+        case AsgNode::Kind::MulDiv:
+            return self->visitMulDiv(static_cast<AsgMulDiv*>(node));
+        case AsgNode::Kind::FieldAccess:
+            return self->visitFieldAccess(static_cast<AsgFieldAccess*>(node));
+        case AsgNode::Kind::Indexing:
+            return self->visitIndexing(static_cast<AsgIndexing*>(node));
+        case AsgNode::Kind::OpDeref:
+            return self->visitOpDeref(static_cast<AsgOpDeref*>(node));
+        case AsgNode::Kind::OpRef:
+            return self->visitOpRef(static_cast<AsgOpRef*>(node));
+        case AsgNode::Kind::Variable:
+            return self->visitVariable(static_cast<AsgVariable*>(node));
+        case AsgNode::Kind::Call:
+            return self->visitCall(static_cast<AsgCall*>(node));
+        case AsgNode::Kind::IntLiteral:
+            return self->visitIntLiteral(static_cast<AsgIntLiteral*>(node));
+        }
+        TC_ASSERT_FAIL("unexpected asg node kind");
+        return R();
+    }
+
+    R visit(const std::unique_ptr<AsgNode>& node)
+    {
+        return visit(node.get());
+    }
 };
 
 #endif
@@ -2,19 +2,39 @@
 
 #include "asg/AsgNode.h"
 
+static TypeRef getTypeRef(
+    TinyCParser::TypeContext* type,
+    const std::vector<TinyCParser::ConstantIndexingContext*>& indexes = {})
+{
+    TypeRef ref;
+    ref.name = Identifier::get(type->typeName()->getText());
+    ref.ptrDepth = type->ASTERISK().size();
+    for (auto* indexing : indexes) {
+        auto* size = indexing->INT_LITERAL();
+        ref.dimensions.push_back(size ? std::stoi(size->getText()) : -1);
+    }
+    return ref;
+}
+
 std::any AstVisitor::modify(std::any data)
 {
-    if (data.type() != typeid(TinyCParser::TranslationUnitContext*)) {
-        TC_LOG_CRITICAL("Unexpected data type passed to AstVisitor -- expected TranslationUnitContext*");
+    if (data.type() != typeid(std::shared_ptr<ParsedUnit>)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to AstVisitor -- expected ParsedUnit");
         return {};
     }
-    auto* ctx = std::any_cast<TinyCParser::TranslationUnitContext*>(data);
+    // the parse tree, tokens and source are freed when this stage returns
+    auto unit = std::any_cast<std::shared_ptr<ParsedUnit>>(std::move(data));
 
-    auto ret = visitTranslationUnit(ctx);
+    auto ret = visitTranslationUnit(unit->tree);
 
     return ret.as<AsgNode*>();
 }
 
+std::string_view AstVisitor::getName() const
+{
+    return "ast build";
+}
+
 antlrcpp::Any AstVisitor::visitTranslationUnit(TinyCParser::TranslationUnitContext* ctx)
 {
     auto node = std::make_unique<AsgStatementList>();
@@ -29,20 +49,11 @@ antlrcpp::Any AstVisitor::visitStructDef(TinyCParser::StructDefContext* ctx)
 {
     auto node = std::make_unique<AsgStructDefinition>();
     node->refLine = ctx->start->getLine();
-    node->name = ctx->IDENTIFIER()->getText();
+    node->name = Identifier::get(ctx->IDENTIFIER()->getText());
     for (auto* field : ctx->structField()) {
         AsgStructDefinition::Field f;
-        const auto& indexes = field->constantIndexing();
-        f.type = field->type()->typeName()->getText()
-               + std::string(field->type()->ASTERISK().size(), '*')
-               + std::accumulate(
-                     indexes.begin(),
-                     indexes.end(),
-                     std::string{},
-                     [](const std::string& accum, TinyCParser::ConstantIndexingContext* indexing) {
-                         return accum + indexing->getText();
-                     });
-        f.name = field->IDENTIFIER()->getText();
+        f.type = getTypeRef(field->type(), field->constantIndexing());
+        f.name = Identifier::get(field->IDENTIFIER()->getText());
         f.refLine = field->type()->start->getLine();
         node->fields.push_back(f);
     }
@@ -53,25 +64,14 @@ antlrcpp::Any AstVisitor::visitFunctionDef(TinyCParser::FunctionDefContext* ctx)
 {
     auto node = std::make_unique<AsgFunctionDefinition>();
     node->refLine = ctx->start->getLine();
-    node->returnType = ctx->type()->typeName()->getText()
-                     + std::string(ctx->type()->ASTERISK().size(), '*');
-    node->name = ctx->functionName()->getText();
+    node->returnType = getTypeRef(ctx->type());
+    node->name = Identifier::get(ctx->functionName()->getText());
 
     if (auto* params = ctx->parameters()) {
         for (auto* paramCtx : params->parameter()) {
-            const auto& indexes = paramCtx->constantIndexing();
-
             AsgFunctionDefinition::Parameter p;
-            p.type = paramCtx->type()->typeName()->getText()
-                   + std::string(paramCtx->type()->ASTERISK().size(), '*')
-                   + std::accumulate(
-                         indexes.begin(),
-                         indexes.end(),
-                         std::string{},
-                         [](const std::string& accum, TinyCParser::ConstantIndexingContext* indexing) {
-                             return accum + indexing->getText();
-                         });
-            p.name = paramCtx->variableName()->getText();
+            p.type = getTypeRef(paramCtx->type(), paramCtx->constantIndexing());
+            p.name = Identifier::get(paramCtx->variableName()->getText());
 
             node->parameters.push_back(p);
         }
@@ -91,15 +91,13 @@ antlrcpp::Any AstVisitor::visitStatements(TinyCParser::StatementsContext* ctx)
     node->refLine = ctx->start->getLine();
 
     for (auto* statement : ctx->statement()) {
-
         auto stmtNode = visit(statement);
 
         if (stmtNode.is<AsgReturn*>()) {
             node->statements.emplace_back(stmtNode.as<AsgReturn*>());
             break;
         }
-        auto* s = visit(statement).as<AsgNode*>();
-        node->statements.emplace_back(s);
+        node->statements.emplace_back(stmtNode.as<AsgNode*>());
     }
 
     return (AsgNode*)node.release();
@@ -154,19 +152,8 @@ antlrcpp::Any AstVisitor::visitVariableDecl(TinyCParser::VariableDeclContext* ct
 {
     auto node = std::make_unique<AsgVariableDefinition>();
     node->refLine = ctx->start->getLine();
-    const auto& indexes = ctx->constantIndexing();
-
-    node->type = ctx->type()->typeName()->getText()
-               + std::string(ctx->type()->ASTERISK().size(), '*')
-               + std::accumulate(
-                     indexes.begin(),
-                     indexes.end(),
-                     std::string{},
-                     [](const std::string& accum, TinyCParser::ConstantIndexingContext* indexing) {
-                         return accum + indexing->getText();
-                     });
-
-    node->name = ctx->variableName()->getText();
+    node->type = getTypeRef(ctx->type(), ctx->constantIndexing());
+    node->name = Identifier::get(ctx->variableName()->getText());
 
     if (ctx->expression()) {
         auto* e = visit(ctx->expression()).as<AsgNode*>();
@@ -358,7 +345,7 @@ antlrcpp::Any AstVisitor::visitFieldAccess(TinyCParser::FieldAccessContext* ctx)
 
         auto accNode = std::make_unique<AsgFieldAccess>();
         accNode->refLine = access->getStart()->getLine();
-        accNode->field = access->IDENTIFIER()->getText();
+        accNode->field = Identifier::get(access->IDENTIFIER()->getText());
         accNode->accessed.reset(accessed);
 
         if (access->indexing().empty()) {
@@ -396,7 +383,7 @@ antlrcpp::Any AstVisitor::visitCallExpr(TinyCParser::CallExprContext* ctx)
 {
     auto node = std::make_unique<AsgCall>();
 
-    node->functionName = ctx->functionName()->getText();
+    node->functionName = Identifier::get(ctx->functionName()->getText());
     node->refLine = ctx->start->getLine();
     if (auto* argumentsCtx = ctx->arguments()) {
         for (auto* argumentCtx : argumentsCtx->argument()) {
@@ -421,7 +408,7 @@ antlrcpp::Any AstVisitor::visitVariableName(TinyCParser::VariableNameContext* ct
 {
     auto node = std::make_unique<AsgVariable>();
     node->refLine = ctx->start->getLine();
-    node->name = ctx->getText();
+    node->name = Identifier::get(ctx->getText());
 
     return (AsgNode*)node.release();
 }
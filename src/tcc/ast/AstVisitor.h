@@ -2,12 +2,14 @@
 #define TINYC_ASTVISITOR_H
 
 #include "pipeline/PipelineStage.h"
+#include "pipeline/input/ParsedUnit.h"
 #include "TinyCBaseVisitor.h"
 
 class AstVisitor : public TinyCBaseVisitor,
                    public PipeModifierBase {
 public:
     std::any modify(std::any data) override;
+    std::string_view getName() const override;
 
     antlrcpp::Any visitTranslationUnit(TinyCParser::TranslationUnitContext* ctx) override;
     antlrcpp::Any visitStructDef(TinyCParser::StructDefContext* ctx) override;
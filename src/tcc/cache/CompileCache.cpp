@@ -0,0 +1,124 @@
+#include "CompileCache.h"
+
+CompileCache::CompileCache(std::string directory, uint64_t maxSizeBytes)
+    : directory_(std::move(directory))
+    , max_size_bytes_(maxSizeBytes)
+{
+}
+
+bool CompileCache::fetch(const std::string& key, const std::string& outputName) const
+{
+    auto entry = getEntryPath(key);
+    if (!touch(entry)) {
+        return false;
+    }
+
+    if (auto ec = llvm::sys::fs::copy_file(entry, outputName)) {
+        TC_LOG_WARN("can not copy cached {} -- {}", outputName, ec.message());
+        return false;
+    }
+    if (auto permissions = llvm::sys::fs::getPermissions(entry)) {
+        TC_UNUSED(llvm::sys::fs::setPermissions(outputName, *permissions));
+    }
+    return true;
+}
+
+void CompileCache::store(const std::string& key, const std::string& outputName)
+{
+    commit(key, outputName, [&](const std::string& tempName) {
+        if (auto ec = llvm::sys::fs::copy_file(outputName, tempName)) {
+            return ec;
+        }
+        if (auto permissions = llvm::sys::fs::getPermissions(outputName)) {
+            return llvm::sys::fs::setPermissions(tempName, *permissions);
+        }
+        return std::error_code{};
+    });
+}
+
+std::unique_ptr<llvm::MemoryBuffer> CompileCache::load(const std::string& key) const
+{
+    auto entry = getEntryPath(key);
+    if (!touch(entry)) {
+        return nullptr;
+    }
+
+    auto buffer = llvm::MemoryBuffer::getFile(entry);
+    if (!buffer) {
+        return nullptr;
+    }
+    return std::move(*buffer);
+}
+
+void CompileCache::save(const std::string& key, llvm::StringRef data)
+{
+    commit(key, key, [&](const std::string& tempName) {
+        std::error_code ec;
+        llvm::raw_fd_ostream ostream{tempName, ec, llvm::sys::fs::OF_None};
+        if (ec) {
+            return ec;
+        }
+        ostream << data;
+        ostream.close();
+        return ostream.error();
+    });
+}
+
+void CompileCache::prune() const
+{
+    if (!stored_) {
+        return;
+    }
+    llvm::CachePruningPolicy policy;
+    policy.Interval = std::chrono::seconds{0};
+    policy.Expiration = std::chrono::seconds{0};
+    policy.MaxSizeBytes = max_size_bytes_;
+    TC_UNUSED(llvm::pruneCache(directory_, policy));
+}
+
+bool CompileCache::touch(const std::string& entry) const
+{
+    int fd;
+    if (llvm::sys::fs::openFileForRead(entry, fd)) {
+        return false;
+    }
+    TC_UNUSED(llvm::sys::fs::setLastAccessAndModificationTime(fd, std::chrono::system_clock::now()));
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+    return true;
+}
+
+void CompileCache::commit(const std::string& key, const std::string& what, const std::function<std::error_code(const std::string&)>& write)
+{
+    if (auto ec = llvm::sys::fs::create_directories(directory_)) {
+        TC_LOG_WARN("can not create cache directory {} -- {}", directory_, ec.message());
+        return;
+    }
+
+    llvm::SmallString<128> tempName{directory_};
+    llvm::sys::path::append(tempName, "tmp-%%%%%%%%");
+    int fd;
+    if (auto ec = llvm::sys::fs::createUniqueFile(tempName, fd, tempName)) {
+        TC_LOG_WARN("can not create cache entry for {} -- {}", what, ec.message());
+        return;
+    }
+    llvm::sys::Process::SafelyCloseFileDescriptor(fd);
+    llvm::FileRemover tempRemover{tempName};
+
+    if (auto ec = write(std::string{tempName})) {
+        TC_LOG_WARN("can not write cache entry for {} -- {}", what, ec.message());
+        return;
+    }
+    if (auto ec = llvm::sys::fs::rename(tempName, getEntryPath(key))) {
+        TC_LOG_WARN("can not commit cache entry for {} -- {}", what, ec.message());
+        return;
+    }
+    tempRemover.releaseFile();
+    stored_ = true;
+}
+
+std::string CompileCache::getEntryPath(const std::string& key) const
+{
+    llvm::SmallString<128> path{directory_};
+    llvm::sys::path::append(path, "llvmcache-" + key);
+    return std::string{path};
+}
@@ -0,0 +1,26 @@
+#ifndef TINYC_COMPILECACHE_H
+#define TINYC_COMPILECACHE_H
+
+class CompileCache {
+public:
+    CompileCache(std::string directory, uint64_t maxSizeBytes);
+
+    bool fetch(const std::string& key, const std::string& outputName) const;
+    void store(const std::string& key, const std::string& outputName);
+
+    std::unique_ptr<llvm::MemoryBuffer> load(const std::string& key) const;
+    void save(const std::string& key, llvm::StringRef data);
+
+    void prune() const;
+
+private:
+    bool touch(const std::string& entry) const;
+    void commit(const std::string& key, const std::string& what, const std::function<std::error_code(const std::string&)>& write);
+    std::string getEntryPath(const std::string& key) const;
+
+    std::string directory_;
+    uint64_t max_size_bytes_;
+    std::atomic<bool> stored_ = false;
+};
+
+#endif
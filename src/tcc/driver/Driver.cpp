@@ -0,0 +1,392 @@
+#include "Driver.h"
+
+#include "asg/AsgArena.h"
+#include "ast/AstVisitor.h"
+#include "ir/IncrementalOptimizer.h"
+#include "ir/IrEmitter.h"
+#include "ir/IrOptimizer.h"
+#include "pipeline/input/FileReader.h"
+#include "pipeline/input/ModuleLinker.h"
+#include "pipeline/input/SourceParser.h"
+#include "pipeline/output/BitcodeBuffer.h"
+#include "pipeline/output/BitcodeWriter.h"
+#include "pipeline/output/FileWriter.h"
+#include "pipeline/output/JitRunner.h"
+#include "pipeline/output/ObjectWriter.h"
+#include "pipeline/output/TerminalWriter.h"
+#include "prof/Trace.h"
+#include "symbols/SymbolResolver.h"
+#include "symbols/TypeResolver.h"
+#include "utils/Parallel.h"
+#include "version/Version.h"
+
+static std::string getModuleName(const std::string& input)
+{
+    auto moduleName = input;
+    auto lastPathChar = moduleName.find_last_of('/');
+    if (lastPathChar == std::string::npos) {
+        lastPathChar = moduleName.find_last_of('\\');
+    } else {
+        auto l = moduleName.find_last_of('\\');
+        if (l != std::string::npos && l > lastPathChar) {
+            lastPathChar = l;
+        }
+    }
+    if (lastPathChar != std::string::npos) {
+        moduleName.erase(0, lastPathChar + 1);
+    }
+    return moduleName;
+}
+
+static std::string getOutputExtension(const std::string& emit)
+{
+    if (emit == "bc") {
+        return ".bc";
+    }
+    if (emit == "asm") {
+        return ".s";
+    }
+    if (emit == "obj") {
+        return ".o";
+    }
+    if (emit == "exe") {
+#if defined(TC_WINDOWS)
+        return ".exe";
+#else
+        return "";
+#endif
+    }
+    return ".ll";
+}
+
+Driver::Driver(DriverOptions options)
+    : options_(std::move(options))
+{
+    if (!options_.cacheDir.empty()) {
+        cache_.emplace(options_.cacheDir, uint64_t{options_.cacheSizeMb} << 20);
+    }
+}
+
+int Driver::run()
+{
+    // the server runs many drivers in one process, events of a previous request must not leak into this one
+    traceReset();
+    if (!options_.trace.empty()) {
+        traceEnable();
+    }
+
+    if (options_.warmParser && options_.parser == "antlr") {
+        FileReader::warmUp();
+    }
+
+    if (options_.run && !options_.lto) {
+        auto exitCode = compileAndRun(options_.inputs.front());
+        if (cache_) {
+            cache_->prune();
+        }
+        if (!writeReports()) {
+            return EXIT_FAILURE;
+        }
+        return exitCode;
+    }
+
+    if (options_.print && options_.emit != "ll" && options_.emit != "asm") {
+        TC_LOG_ERROR("can not print {} output to stdout", options_.emit);
+        return EXIT_FAILURE;
+    }
+
+    if (options_.lto) {
+        auto exitCode = compileAndLink();
+        if (!writeReports()) {
+            return EXIT_FAILURE;
+        }
+        return exitCode;
+    }
+
+    std::atomic<bool> ok = true;
+    parallelFor(options_.inputs.size(), options_.jobs, [&](size_t i) {
+        if (!compile(options_.inputs[i])) {
+            ok = false;
+        }
+    });
+
+    if (cache_) {
+        cache_->prune();
+    }
+    if (!writeReports()) {
+        return EXIT_FAILURE;
+    }
+    return ok ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+bool Driver::compile(const std::string& input)
+{
+    TraceScope trace{"compile", getModuleName(input)};
+
+    TypeLibrary types;
+    FunctionLibrary functions;
+    AsgArena arena;
+    AsgArena::Scope arenaScope{arena};
+
+    auto targetMachine = createTargetMachine(options_.target, options_.optLevel);
+    if (!targetMachine) {
+        return false;
+    }
+
+    auto outputName = getOutputName(input);
+
+    std::string cacheKey;
+    if (cache_ && !options_.print) {
+        cacheKey = getCacheKey(input, *targetMachine);
+        if (!cacheKey.empty() && cache_->fetch(cacheKey, outputName)) {
+            TC_LOG_INFO("compilation finished -> {} (cached)", outputName);
+            return true;
+        }
+    }
+
+    Pipeline pipeline;
+    addFrontend(pipeline, input, types, functions);
+    pipeline.add(std::make_unique<IrEmitter>(getModuleName(input), types, *targetMachine));
+    addBackend(pipeline, *targetMachine, IrOptimizer::Phase::PerModule);
+    pipeline.add(makeOutput(outputName, *targetMachine));
+
+    if (!pipeline.run()) {
+        TC_LOG_ERROR("compilation of {} failed due to errors", input);
+        return false;
+    }
+    if (!cacheKey.empty()) {
+        cache_->store(cacheKey, outputName);
+    }
+    if (!options_.print) {
+        TC_LOG_INFO("compilation finished -> {}", outputName);
+    }
+    return true;
+}
+
+int Driver::compileAndRun(const std::string& input)
+{
+    TraceScope trace{"compile", getModuleName(input)};
+
+    TypeLibrary types;
+    FunctionLibrary functions;
+    AsgArena arena;
+    AsgArena::Scope arenaScope{arena};
+
+    auto targetMachine = createTargetMachine(options_.target, options_.optLevel);
+    if (!targetMachine) {
+        return EXIT_FAILURE;
+    }
+
+    auto runner = std::make_unique<JitRunner>(options_.jitTiming);
+    auto* runnerPtr = runner.get();
+
+    Pipeline pipeline;
+    addFrontend(pipeline, input, types, functions);
+    pipeline.add(std::make_unique<IrEmitter>(getModuleName(input), types, *targetMachine, runner->getContext()));
+    addBackend(pipeline, *targetMachine, IrOptimizer::Phase::PerModule);
+    pipeline.add(std::move(runner));
+
+    if (!pipeline.run()) {
+        TC_LOG_ERROR("compilation of {} failed due to errors", input);
+        return EXIT_FAILURE;
+    }
+    return runnerPtr->getExitCode();
+}
+
+bool Driver::compileToBitcode(const std::string& input, llvm::SmallVectorImpl<char>& bitcode)
+{
+    TraceScope trace{"compile", getModuleName(input)};
+
+    TypeLibrary types;
+    FunctionLibrary functions;
+    AsgArena arena;
+    AsgArena::Scope arenaScope{arena};
+
+    auto targetMachine = createTargetMachine(options_.target, options_.optLevel);
+    if (!targetMachine) {
+        return false;
+    }
+
+    Pipeline pipeline;
+    addFrontend(pipeline, input, types, functions);
+    pipeline.add(std::make_unique<IrEmitter>(getModuleName(input), types, *targetMachine));
+    addBackend(pipeline, *targetMachine, IrOptimizer::Phase::PreLink);
+    pipeline.add(std::make_unique<BitcodeBuffer>(bitcode));
+
+    if (!pipeline.run()) {
+        TC_LOG_ERROR("compilation of {} failed due to errors", input);
+        return false;
+    }
+    return true;
+}
+
+int Driver::compileAndLink()
+{
+    std::vector<llvm::SmallVector<char, 0>> bitcodes(options_.inputs.size());
+    std::atomic<bool> ok = true;
+    parallelFor(options_.inputs.size(), options_.jobs, [&](size_t i) {
+        if (!compileToBitcode(options_.inputs[i], bitcodes[i])) {
+            ok = false;
+        }
+    });
+    if (!ok) {
+        return EXIT_FAILURE;
+    }
+
+    auto outputName = getOutputName(options_.inputs.front());
+    auto moduleName = getModuleName(outputName);
+    TraceScope trace{"link", moduleName};
+
+    auto targetMachine = createTargetMachine(options_.target, options_.optLevel);
+    if (!targetMachine) {
+        return EXIT_FAILURE;
+    }
+
+    Pipeline pipeline;
+    if (!options_.timeReport.empty()) {
+        pipeline.setTimeReport(&time_report_);
+    }
+
+    const auto internalize = options_.run || options_.emit == "exe";
+    std::unique_ptr<JitRunner> runner;
+    if (options_.run) {
+        runner = std::make_unique<JitRunner>(options_.jitTiming);
+        pipeline.add(std::make_unique<ModuleLinker>(moduleName, std::move(bitcodes), internalize, runner->getContext()));
+    } else {
+        pipeline.add(std::make_unique<ModuleLinker>(moduleName, std::move(bitcodes), internalize));
+    }
+    addBackend(pipeline, *targetMachine, IrOptimizer::Phase::Link);
+
+    auto* runnerPtr = runner.get();
+    if (runner) {
+        pipeline.add(std::move(runner));
+    } else {
+        pipeline.add(makeOutput(outputName, *targetMachine));
+    }
+
+    if (!pipeline.run()) {
+        TC_LOG_ERROR("linking {} failed due to errors", outputName);
+        return EXIT_FAILURE;
+    }
+    if (runnerPtr) {
+        return runnerPtr->getExitCode();
+    }
+    if (!options_.print) {
+        TC_LOG_INFO("compilation finished -> {}", outputName);
+    }
+    return EXIT_SUCCESS;
+}
+
+void Driver::addFrontend(Pipeline& pipeline, const std::string& input, TypeLibrary& types, FunctionLibrary& functions)
+{
+    if (!options_.timeReport.empty()) {
+        pipeline.setTimeReport(&time_report_);
+    }
+
+    if (options_.parser == "rd") {
+        pipeline.add(std::make_unique<SourceParser>(input, options_.parseJobs));
+    } else {
+        pipeline
+            .add(std::make_unique<FileReader>(input, options_.lexer == "fast"))
+            .add(std::make_unique<AstVisitor>());
+    }
+
+    pipeline
+        .add(std::make_unique<SymbolResolver>(types, functions))
+        .add(std::make_unique<TypeResolver>(types));
+}
+
+void Driver::addBackend(Pipeline& pipeline, llvm::TargetMachine& targetMachine, IrOptimizer::Phase phase)
+{
+    if (phase == IrOptimizer::Phase::PreLink) {
+        if (options_.optLevel != llvm::OptimizationLevel::O0) {
+            pipeline.add(std::make_unique<IrOptimizer>(targetMachine, options_.optLevel, std::string{}, phase));
+        }
+        return;
+    }
+    if (options_.optLevel == llvm::OptimizationLevel::O0 && options_.passes.empty()) {
+        return;
+    }
+    if (phase == IrOptimizer::Phase::PerModule && options_.incremental) {
+        pipeline.add(std::make_unique<IncrementalOptimizer>(*cache_, targetMachine, options_.optLevel, options_.passes));
+    } else {
+        pipeline.add(std::make_unique<IrOptimizer>(targetMachine, options_.optLevel, options_.passes, phase));
+    }
+}
+
+bool Driver::writeReports() const
+{
+    if (options_.timeReport == "json") {
+        time_report_.printJson(std::cerr);
+    } else if (options_.timeReport == "table") {
+        time_report_.printTable(std::cerr);
+    }
+    if (!options_.trace.empty()) {
+        return traceWrite(options_.trace);
+    }
+    return true;
+}
+
+std::unique_ptr<PipeOutputBase> Driver::makeOutput(const std::string& outputName, llvm::TargetMachine& targetMachine) const
+{
+    if (options_.print) {
+        if (options_.emit == "asm") {
+            return std::make_unique<ObjectWriter>("-", ObjectWriter::Kind::Assembly, targetMachine);
+        }
+        return std::make_unique<TerminalWriter>();
+    }
+    if (options_.emit == "bc") {
+        return std::make_unique<BitcodeWriter>(outputName);
+    }
+    if (options_.emit == "asm") {
+        return std::make_unique<ObjectWriter>(outputName, ObjectWriter::Kind::Assembly, targetMachine);
+    }
+    if (options_.emit == "obj") {
+        return std::make_unique<ObjectWriter>(outputName, ObjectWriter::Kind::Object, targetMachine);
+    }
+    if (options_.emit == "exe") {
+        return std::make_unique<ObjectWriter>(outputName, ObjectWriter::Kind::Executable, targetMachine);
+    }
+    return std::make_unique<FileWriter>(outputName);
+}
+
+std::string Driver::getCacheKey(const std::string& input, const llvm::TargetMachine& targetMachine) const
+{
+    auto source = llvm::MemoryBuffer::getFile(input);
+    if (!source) {
+        return {};
+    }
+
+    const std::string parts[] = {
+        getVersion(),
+        getModuleName(input),
+        options_.emit,
+        std::to_string(options_.optLevel.getSpeedupLevel()),
+        std::to_string(options_.optLevel.getSizeLevel()),
+        options_.passes,
+        options_.incremental ? "incremental" : "",
+        targetMachine.getTargetTriple().str(),
+        targetMachine.getTargetCPU().str(),
+        targetMachine.getTargetFeatureString().str()};
+
+    llvm::SHA1 hasher;
+    for (const auto& part : parts) {
+        hasher.update(part);
+        hasher.update(llvm::StringRef{"\0", 1});
+    }
+    hasher.update((*source)->getBuffer());
+    return llvm::toHex(hasher.final(), true);
+}
+
+std::string Driver::getOutputName(const std::string& input) const
+{
+    if (!options_.output.empty()) {
+        return options_.output;
+    }
+    auto outputName = input;
+    auto lastDot = outputName.find_last_of('.');
+    if (lastDot != std::string::npos) {
+        outputName.erase(lastDot);
+    }
+    return outputName + getOutputExtension(options_.emit);
+}
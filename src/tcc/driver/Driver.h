@@ -0,0 +1,36 @@
+#ifndef TINYC_DRIVER_H
+#define TINYC_DRIVER_H
+
+#include "DriverOptions.h"
+#include "cache/CompileCache.h"
+#include "ir/IrOptimizer.h"
+#include "pipeline/Pipeline.h"
+#include "prof/TimeReport.h"
+#include "symbols/FunctionLib.h"
+#include "symbols/TypeLib.h"
+
+class Driver {
+public:
+    explicit Driver(DriverOptions options);
+
+    int run();
+
+private:
+    bool compile(const std::string& input);
+    int compileAndRun(const std::string& input);
+    bool compileToBitcode(const std::string& input, llvm::SmallVectorImpl<char>& bitcode);
+    int compileAndLink();
+
+    void addFrontend(Pipeline& pipeline, const std::string& input, TypeLibrary& types, FunctionLibrary& functions);
+    void addBackend(Pipeline& pipeline, llvm::TargetMachine& targetMachine, IrOptimizer::Phase phase);
+    bool writeReports() const;
+    std::unique_ptr<PipeOutputBase> makeOutput(const std::string& outputName, llvm::TargetMachine& targetMachine) const;
+    std::string getCacheKey(const std::string& input, const llvm::TargetMachine& targetMachine) const;
+    std::string getOutputName(const std::string& input) const;
+
+    DriverOptions options_;
+    TimeReport time_report_;
+    std::optional<CompileCache> cache_;
+};
+
+#endif
@@ -0,0 +1,263 @@
+#include "DriverOptions.h"
+
+#include "version/Version.h"
+
+static std::vector<std::string> splitAssignedArgs(const std::vector<std::string>& args)
+{
+    std::vector<std::string> split;
+    for (const auto& arg : args) {
+        auto eq = arg.find('=');
+        if (arg.rfind("--", 0) == 0 && eq != std::string::npos) {
+            split.push_back(arg.substr(0, eq));
+            split.push_back(arg.substr(eq + 1));
+        } else if (arg.rfind("-O", 0) == 0 && arg.size() > 2) {
+            split.push_back("-O");
+            split.push_back(arg.substr(2));
+        } else {
+            split.push_back(arg);
+        }
+    }
+    return split;
+}
+
+static std::optional<llvm::OptimizationLevel> getOptLevel(const std::string& level)
+{
+    static const std::unordered_map<std::string, llvm::OptimizationLevel> levels{
+        {"0", llvm::OptimizationLevel::O0},
+        {"1", llvm::OptimizationLevel::O1},
+        {"2", llvm::OptimizationLevel::O2},
+        {"3", llvm::OptimizationLevel::O3},
+        {"s", llvm::OptimizationLevel::Os},
+        {"z", llvm::OptimizationLevel::Oz}};
+
+    auto found = levels.find(level);
+    if (found == levels.end()) {
+        return std::nullopt;
+    }
+    return found->second;
+}
+
+std::optional<DriverOptions> parseDriverOptions(const std::vector<std::string>& args)
+{
+    argparse::ArgumentParser program{"tcc", getVersion()};
+
+    program.add_argument("input")
+        .help("specify the input files")
+        .default_value(std::vector<std::string>{})
+        .nargs(argparse::nargs_pattern::any);
+
+    program.add_argument("-o", "--output")
+        .help("specify the output file, only allowed with a single input")
+        .default_value(std::string{});
+
+    program.add_argument("--emit")
+        .help("output kind: ll, bc, asm, obj or exe")
+        .default_value(std::string{"ll"})
+        .action([](const std::string& value) {
+            static const std::vector<std::string> choices{"ll", "bc", "asm", "obj", "exe"};
+            if (std::find(choices.begin(), choices.end(), value) == choices.end()) {
+                throw std::runtime_error{"unknown --emit kind " + value};
+            }
+            return value;
+        });
+
+    program.add_argument("--lexer")
+        .help("lexer used by the parser: antlr or fast")
+        .default_value(std::string{"antlr"})
+        .action([](const std::string& value) {
+            static const std::vector<std::string> choices{"antlr", "fast"};
+            if (std::find(choices.begin(), choices.end(), value) == choices.end()) {
+                throw std::runtime_error{"unknown --lexer kind " + value};
+            }
+            return value;
+        });
+
+    program.add_argument("--parser")
+        .help("front end: antlr, or rd for the recursive descent parser which always uses the fast lexer")
+        .default_value(std::string{"antlr"})
+        .action([](const std::string& value) {
+            static const std::vector<std::string> choices{"antlr", "rd"};
+            if (std::find(choices.begin(), choices.end(), value) == choices.end()) {
+                throw std::runtime_error{"unknown --parser kind " + value};
+            }
+            return value;
+        });
+
+    program.add_argument("--parse-jobs")
+        .help("number of threads parsing the top level entities of a large input, only used with --parser=rd")
+        .default_value(1u)
+        .scan<'u', unsigned>();
+
+    program.add_argument("--warm-parser")
+        .help("fill the prediction cache of the antlr parser before parsing, it is shared by all inputs of the process")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("-j", "--jobs")
+        .help("number of translation units compiled in parallel")
+        .default_value(std::max(1u, std::thread::hardware_concurrency()))
+        .scan<'u', unsigned>();
+
+    program.add_argument("-O")
+        .help("optimization level: 0, 1, 2, 3, s or z")
+        .default_value(std::string{"2"})
+        .action([](const std::string& value) {
+            if (!getOptLevel(value)) {
+                throw std::runtime_error{"unknown optimization level -O" + value};
+            }
+            return value;
+        });
+
+    program.add_argument("--passes")
+        .help("run the given textual pass pipeline instead of the -O pipeline")
+        .default_value(std::string{});
+
+    program.add_argument("--no-opt")
+        .help("disable optimizations, same as -O0")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--target")
+        .help("target triple, defaults to the host")
+        .default_value(std::string{});
+
+    program.add_argument("--mcpu")
+        .help("target cpu, native selects the host cpu and its features")
+        .default_value(std::string{"generic"});
+
+    program.add_argument("--mattr")
+        .help("comma separated target features, e.g. +avx2,-avx512f")
+        .default_value(std::string{});
+
+    program.add_argument("--lto")
+        .help("link all inputs into a single module and optimize it as a whole")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("-p", "--print")
+        .help("print IR to stdout instead of creating output file")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--run")
+        .help("compile in memory and run main instead of creating output file")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--jit-timing")
+        .help("report JIT compile and run time separately when used with --run")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--time-report")
+        .help("report wall time, cpu time and peak rss growth of every stage: table or json")
+        .default_value(std::string{})
+        .action([](const std::string& value) {
+            if (value != "table" && value != "json") {
+                throw std::runtime_error{"unknown --time-report format " + value};
+            }
+            return value;
+        });
+
+    program.add_argument("--trace")
+        .help("write chrome trace events of stages, functions and passes to the given file")
+        .default_value(std::string{});
+
+    program.add_argument("--cache-dir")
+        .help("reuse outputs of unchanged inputs from the given directory")
+        .default_value(std::string{});
+
+    program.add_argument("--cache-size")
+        .help("size limit of the cache directory in MiB, least recently used entries are evicted first, 0 disables the limit")
+        .default_value(512u)
+        .scan<'u', unsigned>();
+
+    program.add_argument("--incremental")
+        .help("optimize every function separately and reuse unchanged ones from --cache-dir")
+        .default_value(false)
+        .implicit_value(true);
+
+    program.add_argument("--server")
+        .help("keep the compiler resident and serve compile requests on the given unix socket")
+        .default_value(std::string{});
+
+    program.add_argument("--connect")
+        .help("compile on the server listening on the given unix socket, compile in process if it is not reachable")
+        .default_value(std::string{});
+
+    program.add_argument("--dump")
+        .help("create crash dump on failure")
+        .default_value(false)
+        .implicit_value(true);
+
+    try {
+        program.parse_args(splitAssignedArgs(args));
+    } catch (const std::runtime_error& err) {
+        std::cerr << err.what() << std::endl;
+        std::cerr << program;
+        return std::nullopt;
+    }
+
+    DriverOptions options;
+    options.inputs = program.get<std::vector<std::string>>("input");
+    options.output = program.get<std::string>("-o");
+    options.emit = program.get<std::string>("--emit");
+    options.lexer = program.get<std::string>("--lexer");
+    options.parser = program.get<std::string>("--parser");
+    options.parseJobs = std::max(1u, program.get<unsigned>("--parse-jobs"));
+    options.warmParser = program.get<bool>("--warm-parser");
+    options.optLevel = program.get<bool>("--no-opt")
+                         ? llvm::OptimizationLevel::O0
+                         : *getOptLevel(program.get<std::string>("-O"));
+    options.passes = program.get<std::string>("--passes");
+    options.target.triple = program.get<std::string>("--target");
+    options.target.cpu = program.get<std::string>("--mcpu");
+    options.target.features = program.get<std::string>("--mattr");
+    options.lto = program.get<bool>("--lto");
+    options.print = program.get<bool>("-p");
+    options.run = program.get<bool>("--run");
+    options.jitTiming = program.get<bool>("--jit-timing");
+    options.dump = program.get<bool>("--dump");
+    options.timeReport = program.get<std::string>("--time-report");
+    options.trace = program.get<std::string>("--trace");
+    options.cacheDir = program.get<std::string>("--cache-dir");
+    options.cacheSizeMb = program.get<unsigned>("--cache-size");
+    options.incremental = program.get<bool>("--incremental");
+    options.jobs = std::max(1u, program.get<unsigned>("-j"));
+    options.server = program.get<std::string>("--server");
+    options.connect = program.get<std::string>("--connect");
+
+    if (options.inputs.empty() && options.server.empty()) {
+        std::cerr << "no input files" << std::endl;
+        std::cerr << program;
+        return std::nullopt;
+    }
+
+    if (!options.server.empty() && !options.connect.empty()) {
+        std::cerr << "--server can not be used with --connect" << std::endl;
+        return std::nullopt;
+    }
+
+    if (options.inputs.size() > 1 && !options.lto) {
+        if (!options.output.empty()) {
+            std::cerr << "-o can not be used with multiple inputs without --lto" << std::endl;
+            return std::nullopt;
+        }
+        if (options.print || options.run) {
+            std::cerr << "--print and --run require a single input or --lto" << std::endl;
+            return std::nullopt;
+        }
+    }
+
+    if (options.incremental && options.cacheDir.empty()) {
+        std::cerr << "--incremental requires --cache-dir" << std::endl;
+        return std::nullopt;
+    }
+
+    if (options.run && !options.target.triple.empty()) {
+        std::cerr << "--target can not be used with --run" << std::endl;
+        return std::nullopt;
+    }
+
+    return options;
+}
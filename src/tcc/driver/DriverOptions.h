@@ -0,0 +1,34 @@
+#ifndef TINYC_DRIVEROPTIONS_H
+#define TINYC_DRIVEROPTIONS_H
+
+#include "ir/TargetMachine.h"
+
+struct DriverOptions {
+    std::vector<std::string> inputs;
+    std::string output;
+    std::string emit = "ll";
+    std::string lexer = "antlr";
+    std::string parser = "antlr";
+    size_t parseJobs = 1;
+    bool warmParser = false;
+    llvm::OptimizationLevel optLevel = llvm::OptimizationLevel::O2;
+    std::string passes;
+    TargetSpec target;
+    bool lto = false;
+    bool print = false;
+    bool run = false;
+    bool jitTiming = false;
+    bool dump = false;
+    std::string timeReport;
+    std::string trace;
+    std::string cacheDir;
+    size_t cacheSizeMb = 512;
+    bool incremental = false;
+    size_t jobs = 1;
+    std::string server;
+    std::string connect;
+};
+
+std::optional<DriverOptions> parseDriverOptions(const std::vector<std::string>& args);
+
+#endif
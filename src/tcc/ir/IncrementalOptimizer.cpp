@@ -0,0 +1,234 @@
+#include "IncrementalOptimizer.h"
+
+#include "prof/Trace.h"
+#include "version/Version.h"
+
+static std::string getDigest(llvm::StringRef data)
+{
+    llvm::SHA1 hasher;
+    hasher.update(data);
+    return llvm::toHex(hasher.final(), true);
+}
+
+IncrementalOptimizer::IncrementalOptimizer(CompileCache& cache, llvm::TargetMachine& targetMachine, llvm::OptimizationLevel level, std::string passes)
+    : cache_(cache)
+    , target_machine_(targetMachine)
+    , level_(level)
+    , passes_(std::move(passes))
+{
+}
+
+std::any IncrementalOptimizer::modify(std::any data)
+{
+    if (data.type() != typeid(llvm::Module*)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to IncrementalOptimizer -- expected llvm::Module*");
+        return {};
+    }
+    std::unique_ptr<llvm::Module> module{std::any_cast<llvm::Module*>(data)};
+
+    std::string moduleDigest = getOptionsDigest();
+    {
+        llvm::raw_string_ostream ostream{moduleDigest};
+        for (const auto* type : module->getIdentifiedStructTypes()) {
+            type->print(ostream);
+            ostream << '\n';
+        }
+    }
+
+    std::unordered_map<const llvm::Function*, std::string> bodyDigests;
+    for (const auto& function : *module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+        std::string body;
+        llvm::raw_string_ostream ostream{body};
+        function.print(ostream);
+        bodyDigests[&function] = getDigest(ostream.str());
+    }
+
+    auto callees = getCallees(*module);
+
+    std::unordered_map<const llvm::Function*, size_t> positions;
+    for (const auto& function : *module) {
+        const auto position = positions.size();
+        positions[&function] = position;
+    }
+
+    auto linked = std::make_unique<llvm::Module>(module->getModuleIdentifier(), module->getContext());
+    linked->setSourceFileName(module->getSourceFileName());
+    linked->setTargetTriple(module->getTargetTriple());
+    linked->setDataLayout(module->getDataLayout());
+    llvm::Linker linker{*linked};
+
+    for (const auto& function : *module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+        TraceScope trace{"incremental optimization", function.getName()};
+
+        std::vector<const llvm::Function*> unitCallees{callees[&function].begin(), callees[&function].end()};
+        std::sort(unitCallees.begin(), unitCallees.end(), [&](const auto* lhs, const auto* rhs) {
+            return positions[lhs] < positions[rhs];
+        });
+
+        llvm::SHA1 hasher;
+        hasher.update(moduleDigest);
+        hasher.update(bodyDigests[&function]);
+        for (const auto* callee : unitCallees) {
+            hasher.update(callee->getName());
+            hasher.update(bodyDigests[callee]);
+        }
+        auto key = llvm::toHex(hasher.final(), true);
+
+        auto bitcode = cache_.load(key);
+        if (!bitcode) {
+            auto unit = optimizeUnit(function, unitCallees);
+            if (!unit) {
+                return {};
+            }
+            llvm::SmallVector<char, 0> buffer;
+            llvm::raw_svector_ostream ostream{buffer};
+            llvm::WriteBitcodeToFile(*unit, ostream);
+            cache_.save(key, ostream.str());
+            bitcode = llvm::MemoryBuffer::getMemBufferCopy(ostream.str(), function.getName());
+        }
+
+        auto unit = llvm::parseBitcodeFile(bitcode->getMemBufferRef(), module->getContext());
+        if (!unit) {
+            TC_LOG_CRITICAL("can not read optimized {} -- {}", function.getName().str(), llvm::toString(unit.takeError()));
+            return {};
+        }
+        if (linker.linkInModule(std::move(*unit))) {
+            TC_LOG_CRITICAL("can not link optimized {}", function.getName().str());
+            return {};
+        }
+    }
+
+    return linked.release();
+}
+
+std::string_view IncrementalOptimizer::getName() const
+{
+    return "incremental optimization";
+}
+
+std::unordered_map<const llvm::Function*, IncrementalOptimizer::FunctionSet> IncrementalOptimizer::getCallees(const llvm::Module& module)
+{
+    std::unordered_map<const llvm::Function*, FunctionSet> direct;
+    for (const auto& function : module) {
+        if (function.isDeclaration()) {
+            continue;
+        }
+        auto& called = direct[&function];
+        for (const auto& inst : llvm::instructions(function)) {
+            const auto* call = llvm::dyn_cast<llvm::CallBase>(&inst);
+            if (!call) {
+                continue;
+            }
+            const auto* callee = call->getCalledFunction();
+            if (callee && !callee->isDeclaration()) {
+                called.insert(callee);
+            }
+        }
+    }
+
+    std::unordered_map<const llvm::Function*, FunctionSet> transitive;
+    for (const auto& [function, called] : direct) {
+        auto& reachable = transitive[function];
+        std::vector<const llvm::Function*> pending{called.begin(), called.end()};
+        while (!pending.empty()) {
+            const auto* callee = pending.back();
+            pending.pop_back();
+            if (callee != function && reachable.insert(callee).second) {
+                pending.insert(pending.end(), direct[callee].begin(), direct[callee].end());
+            }
+        }
+    }
+    return transitive;
+}
+
+std::string IncrementalOptimizer::getOptionsDigest() const
+{
+    std::stringstream ss;
+    ss << getVersion() << '\n'
+       << level_.getSpeedupLevel() << level_.getSizeLevel() << '\n'
+       << passes_ << '\n'
+       << target_machine_.getTargetTriple().str() << '\n'
+       << target_machine_.getTargetCPU().str() << '\n'
+       << target_machine_.getTargetFeatureString().str() << '\n';
+    return ss.str();
+}
+
+std::unique_ptr<llvm::Module> IncrementalOptimizer::optimizeUnit(
+    const llvm::Function& function,
+    llvm::ArrayRef<const llvm::Function*> callees)
+{
+    const auto& module = *function.getParent();
+    auto unit = std::make_unique<llvm::Module>(function.getName(), module.getContext());
+    unit->setSourceFileName(module.getSourceFileName());
+    unit->setTargetTriple(module.getTargetTriple());
+    unit->setDataLayout(module.getDataLayout());
+
+    // only the function, its callees and the declarations they use go into the unit, cloning the whole
+    // module would make every unit as large as the module
+    llvm::ValueToValueMapTy valueMap;
+    auto declare = [&](const llvm::Function& original) {
+        auto* declared = llvm::Function::Create(
+            original.getFunctionType(),
+            llvm::GlobalValue::ExternalLinkage,
+            original.getAddressSpace(),
+            original.getName(),
+            unit.get());
+        declared->copyAttributesFrom(&original);
+        valueMap[&original] = declared;
+    };
+
+    std::vector<const llvm::Function*> definitions{&function};
+    definitions.insert(definitions.end(), callees.begin(), callees.end());
+
+    for (const auto* definition : definitions) {
+        declare(*definition);
+    }
+    for (const auto* definition : definitions) {
+        for (const auto& inst : llvm::instructions(*definition)) {
+            for (const auto& operand : inst.operands()) {
+                const auto* used = llvm::dyn_cast<llvm::Function>(operand.get());
+                if (used && !valueMap.count(used)) {
+                    declare(*used);
+                }
+            }
+        }
+    }
+
+    for (const auto* definition : definitions) {
+        auto* cloned = llvm::cast<llvm::Function>(valueMap[definition]);
+        auto clonedArg = cloned->arg_begin();
+        for (const auto& arg : definition->args()) {
+            clonedArg->setName(arg.getName());
+            valueMap[&arg] = &*clonedArg++;
+        }
+        llvm::SmallVector<llvm::ReturnInst*, 8> returns;
+        llvm::CloneFunctionInto(cloned, definition, valueMap, llvm::CloneFunctionChangeType::DifferentModule, returns);
+        cloned->setLinkage(definition == &function ? definition->getLinkage() : llvm::GlobalValue::AvailableExternallyLinkage);
+    }
+
+    // CloneFunctionInto leaves an empty compile unit list behind, which readers of the cached bitcode warn about
+    auto* compileUnits = unit->getNamedMetadata("llvm.dbg.cu");
+    if (compileUnits && compileUnits->getNumOperands() == 0) {
+        unit->eraseNamedMetadata(compileUnits);
+    }
+
+    IrOptimizer optimizer{target_machine_, level_, passes_, IrOptimizer::Phase::PerModule};
+    auto optimized = optimizer.modify(unit.release());
+    if (!optimized.has_value()) {
+        return nullptr;
+    }
+    unit.reset(std::any_cast<llvm::Module*>(optimized));
+
+    for (auto& unitFunction : *unit) {
+        if (unitFunction.hasAvailableExternallyLinkage()) {
+            unitFunction.deleteBody();
+        }
+    }
+    return unit;
+}
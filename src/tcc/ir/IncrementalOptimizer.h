@@ -0,0 +1,27 @@
+#ifndef TINYC_INCREMENTALOPTIMIZER_H
+#define TINYC_INCREMENTALOPTIMIZER_H
+
+#include "IrOptimizer.h"
+#include "cache/CompileCache.h"
+
+class IncrementalOptimizer : public PipeModifierBase {
+public:
+    IncrementalOptimizer(CompileCache& cache, llvm::TargetMachine& targetMachine, llvm::OptimizationLevel level, std::string passes);
+
+    std::any modify(std::any data) override;
+    std::string_view getName() const override;
+
+private:
+    using FunctionSet = std::unordered_set<const llvm::Function*>;
+
+    static std::unordered_map<const llvm::Function*, FunctionSet> getCallees(const llvm::Module& module);
+    std::string getOptionsDigest() const;
+    std::unique_ptr<llvm::Module> optimizeUnit(const llvm::Function& function, llvm::ArrayRef<const llvm::Function*> callees);
+
+    CompileCache& cache_;
+    llvm::TargetMachine& target_machine_;
+    llvm::OptimizationLevel level_;
+    std::string passes_;
+};
+
+#endif
@@ -1,10 +1,19 @@
 #include "IrEmitter.h"
 
-#include "symbols/TypeLib.h"
+#include "prof/Trace.h"
 
-IrEmitter::IrEmitter(std::string moduleName, bool optimize)
-    : module_name_(std::move(moduleName))
-    , optimize_(optimize)
+IrEmitter::IrEmitter(std::string moduleName, TypeLibrary& types, const llvm::TargetMachine& targetMachine)
+    : types_(types)
+    , target_machine_(targetMachine)
+    , module_name_(std::move(moduleName))
+{
+}
+
+IrEmitter::IrEmitter(std::string moduleName, TypeLibrary& types, const llvm::TargetMachine& targetMachine, llvm::LLVMContext& context)
+    : types_(types)
+    , target_machine_(targetMachine)
+    , context_(&context)
+    , module_name_(std::move(moduleName))
 {
 }
 
@@ -16,11 +25,16 @@ std::any IrEmitter::modify(std::any data)
     }
     auto* root = std::any_cast<AsgNode*>(data);
 
-    context_ = std::make_unique<llvm::LLVMContext>();
+    if (!context_) {
+        own_context_ = std::make_unique<llvm::LLVMContext>();
+        context_ = own_context_.get();
+    }
     module_ = std::make_unique<llvm::Module>(module_name_, *context_);
+    module_->setTargetTriple(target_machine_.getTargetTriple().str());
+    module_->setDataLayout(target_machine_.createDataLayout());
     builder_ = std::make_unique<llvm::IRBuilder<>>(*context_);
 
-    root->accept(this);
+    visit(root);
     delete root;
 
     if (llvm::verifyModule(*module_, &llvm::errs())) {
@@ -28,66 +42,73 @@ std::any IrEmitter::modify(std::any data)
         ok_ = false;
     }
 
-    if (optimize_ && ok_) {
-        llvm::LoopAnalysisManager LAM;
-        llvm::FunctionAnalysisManager FAM;
-        llvm::CGSCCAnalysisManager CGAM;
-        llvm::ModuleAnalysisManager MAM;
-        llvm::PassBuilder PB;
-        PB.registerModuleAnalyses(MAM);
-        PB.registerCGSCCAnalyses(CGAM);
-        PB.registerFunctionAnalyses(FAM);
-        PB.registerLoopAnalyses(LAM);
-        PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
-        llvm::ModulePassManager MPM = PB.buildPerModuleDefaultPipeline(llvm::OptimizationLevel::O2);
-        MPM.run(*module_, MAM);
-    }
-
     if (!ok_) {
+        // the context may belong to a later stage, which the pipeline destroys before this one
+        builder_.reset();
+        module_.reset();
         return {};
     }
 
     return module_.release();
 }
 
-std::any IrEmitter::visitStatementList(struct AsgStatementList* node)
+std::string_view IrEmitter::getName() const
 {
-    scopes_.emplace_back();
+    return "ir emission";
+}
 
+llvm::Value* IrEmitter::visitStatementList(AsgStatementList* node)
+{
     for (auto& statement : node->statements) {
-        statement->accept(this);
+        visit(statement);
     }
 
-    scopes_.pop_back();
-
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitStructDefinition(struct AsgStructDefinition* node)
+llvm::Value* IrEmitter::visitStructDefinition(AsgStructDefinition* node)
 {
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitFunctionDefinition(struct AsgFunctionDefinition* node)
+llvm::Value* IrEmitter::visitFunctionDefinition(AsgFunctionDefinition* node)
 {
-    expected_ret_.push(RetType::Undef);
-    scopes_.emplace_back();
+    TraceScope trace{"ir emission", node->name.str()};
+
+    llvm::Function* function = module_->getFunction(node->name.str());
+    if (!function) {
+        std::vector<llvm::Type*> paramTypes;
+        for (auto& paramType : node->type->parameters) {
+            paramTypes.push_back(paramType->getLLVMParamType(*context_, 0));
+        }
+
+        llvm::FunctionType* functionType = llvm::FunctionType::get(
+            node->type->returnType->getLLVMType(*context_, 0),
+            paramTypes,
+            false);
+
+        function = llvm::Function::Create(
+            functionType,
+            llvm::Function::ExternalLinkage,
+            node->name.str(),
+            module_.get());
+        function->addFnAttr("target-cpu", target_machine_.getTargetCPU());
+        if (!target_machine_.getTargetFeatureString().empty()) {
+            function->addFnAttr("target-features", target_machine_.getTargetFeatureString());
+        }
 
-    std::vector<llvm::Type*> paramTypes;
-    for (auto& paramType : node->type->parameters) {
-        paramTypes.push_back(paramType->getLLVMParamType(*context_, 0));
+        if (node->type->origRetType) {
+            function->args().begin()->addAttr(llvm::Attribute::getWithStructRetType(
+                *context_, node->type->origRetType->getLLVMType(*context_, 0)));
+        }
     }
 
-    llvm::FunctionType* functionType = llvm::FunctionType::get(
-        node->type->returnType->getLLVMType(*context_, 0),
-        paramTypes,
-        false);
+    if (!node->body) {
+        return nullptr;
+    }
 
-    llvm::Function* function = llvm::Function::Create(
-        functionType,
-        llvm::Function::ExternalLinkage,
-        node->name,
-        module_.get());
+    expected_ret_.push(RetType::Undef);
+    allocas_.assign(node->slots.size(), nullptr);
 
     curr_function_ = function;
 
@@ -97,72 +118,66 @@ std::any IrEmitter::visitFunctionDefinition(struct AsgFunctionDefinition* node)
     {
         auto i = 0;
         for (auto& param : function->args()) {
-            auto& paramName = node->parameters[i++].name;
+            auto& parameter = node->parameters[i++];
 
-            param.setName(paramName + "_arg");
+            param.setName(parameter.name.str() + "_arg");
 
-            llvm::AllocaInst* alloca = makeAlloca(paramName, param.getType());
+            llvm::AllocaInst* alloca = makeAlloca(parameter.name.str(), param.getType());
             builder_->CreateStore(&param, alloca);
 
-            scopes_.back().insert({paramName, alloca});
+            allocas_[parameter.slot] = alloca;
         }
     }
 
-    if (node->type->origRetType) {
-        function->args().begin()->addAttr(llvm::Attribute::getWithStructRetType(
-            *context_, node->type->origRetType->getLLVMType(*context_, 0)));
-    }
-
-    if (node->type->returnType == TypeLibrary::inst().get("void")) {
+    if (node->type->returnType == types_.getVoid()) {
         // ToDo: kill it with fire
         auto* topLevelList = (AsgStatementList*)node->body.get();
-        if (!dynamic_cast<AsgReturn*>(topLevelList->statements.back().get())) {
+        if (!topLevelList->statements.back()->as<AsgReturn>()) {
             topLevelList->statements.push_back(std::make_unique<AsgReturn>());
         }
     }
 
-    node->body->accept(this);
+    visit(node->body);
 
     if (llvm::verifyFunction(*function, &llvm::errs())) {
         TC_LOG_CRITICAL("invalid function {} was emitted by IrEmitter", node->name);
         ok_ = false;
     }
 
-    scopes_.pop_back();
     expected_ret_.pop();
     TC_ASSERT(expected_ret_.empty());
 
     curr_function_ = nullptr;
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitVariableDefinition(struct AsgVariableDefinition* node)
+llvm::Value* IrEmitter::visitVariableDefinition(AsgVariableDefinition* node)
 {
-    auto varType = node->list->localVariables[node->name];
+    auto varType = node->function->slots[node->slot];
 
-    llvm::AllocaInst* alloca = makeAlloca(node->name, varType->getLLVMType(*context_, curr_function_->getAddressSpace()));
+    llvm::AllocaInst* alloca = makeAlloca(node->name.str(), varType->getLLVMType(*context_, curr_function_->getAddressSpace()));
 
-    scopes_.back().insert({node->name, alloca});
+    allocas_[node->slot] = alloca;
 
     if (node->value) {
         expected_ret_.push(RetType::Data);
-        auto* value = std::any_cast<llvm::Value*>(node->value->accept(this));
+        auto* value = visit(node->value);
         builder_->CreateStore(value, alloca);
         expected_ret_.pop();
     }
 
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitReturn(struct AsgReturn* node)
+llvm::Value* IrEmitter::visitReturn(AsgReturn* node)
 {
     if (!node->value) {
         builder_->CreateRetVoid();
-        return {};
+        return nullptr;
     }
 
     expected_ret_.push(RetType::Data);
-    auto* value = std::any_cast<llvm::Value*>(node->value->accept(this));
+    auto* value = visit(node->value);
     expected_ret_.pop();
 
     auto retType = node->value->exprType;
@@ -173,19 +188,19 @@ std::any IrEmitter::visitReturn(struct AsgReturn* node)
 
     builder_->CreateRet(value);
 
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitAssignment(struct AsgAssignment* node)
+llvm::Value* IrEmitter::visitAssignment(AsgAssignment* node)
 {
     expected_ret_.push(RetType::Ptr);
-    auto* assignable = std::any_cast<llvm::Value*>(node->assignable->accept(this));
+    auto* assignable = visit(node->assignable);
     auto assignableType = node->assignable->exprType;
     expected_ret_.pop();
 
     if (assignableType->as<StructType>()) {
         expected_ret_.push(RetType::Ptr);
-        auto* value = std::any_cast<llvm::Value*>(node->value->accept(this));
+        auto* value = visit(node->value);
         auto valType = node->value->exprType;
         expected_ret_.pop();
 
@@ -199,23 +214,23 @@ std::any IrEmitter::visitAssignment(struct AsgAssignment* node)
     }
 
     expected_ret_.push(RetType::Data);
-    auto* value = std::any_cast<llvm::Value*>(node->value->accept(this));
+    auto* value = visit(node->value);
     auto valType = node->value->exprType;
     expected_ret_.pop();
 
     builder_->CreateStore(value, assignable);
 
     if (expected_ret_.top() == RetType::Data) {
-        return (llvm::Value*)builder_->CreateLoad(
+        return builder_->CreateLoad(
             assignableType->getLLVMType(*context_, curr_function_->getAddressSpace()), assignable);
     }
     return assignable;
 }
 
-std::any IrEmitter::visitConditional(struct AsgConditional* node)
+llvm::Value* IrEmitter::visitConditional(AsgConditional* node)
 {
     expected_ret_.push(RetType::Data);
-    auto* condVal = std::any_cast<llvm::Value*>(node->condition->accept(this));
+    auto* condVal = visit(node->condition);
     expected_ret_.pop();
 
     auto* constZero = llvm::ConstantInt::getSigned(llvm::Type::getInt32Ty(*context_), 0);
@@ -230,7 +245,7 @@ std::any IrEmitter::visitConditional(struct AsgConditional* node)
 
     llvm::BasicBlock* mergeBB = nullptr;
 
-    auto* parentList = dynamic_cast<AsgStatementList*>(node->parent);
+    auto* parentList = node->parent ? node->parent->as<AsgStatementList>() : nullptr;
     const auto isLastNode = !parentList || parentList->statements.back().get() == node;
 
     if (!isLastNode) {
@@ -245,7 +260,7 @@ std::any IrEmitter::visitConditional(struct AsgConditional* node)
 
     {
         builder_->SetInsertPoint(thenBB);
-        node->thenNode->accept(this);
+        visit(node->thenNode);
         builder_->SetInsertPoint(thenBB);
         const auto endedWithRet = thenBB->back().isTerminator();
         if (!isLastNode && !endedWithRet) {
@@ -255,7 +270,7 @@ std::any IrEmitter::visitConditional(struct AsgConditional* node)
 
     if (elseBB) {
         builder_->SetInsertPoint(elseBB);
-        node->elseNode->accept(this);
+        visit(node->elseNode);
         builder_->SetInsertPoint(elseBB);
         const auto endedWithRet = elseBB->back().isTerminator();
         if (!isLastNode && !endedWithRet) {
@@ -267,10 +282,10 @@ std::any IrEmitter::visitConditional(struct AsgConditional* node)
         builder_->SetInsertPoint(mergeBB);
     }
 
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitLoop(struct AsgLoop* node)
+llvm::Value* IrEmitter::visitLoop(AsgLoop* node)
 {
     llvm::BasicBlock* condBlock = llvm::BasicBlock::Create(*context_, "loop_cond", curr_function_);
     llvm::BasicBlock* loopBlock = llvm::BasicBlock::Create(*context_, "loop_body", curr_function_);
@@ -280,7 +295,7 @@ std::any IrEmitter::visitLoop(struct AsgLoop* node)
 
     builder_->SetInsertPoint(condBlock);
     expected_ret_.push(RetType::Data);
-    auto* condVal = std::any_cast<llvm::Value*>(node->condition->accept(this));
+    auto* condVal = visit(node->condition);
     expected_ret_.pop();
 
     auto* constZero = llvm::ConstantInt::getSigned(llvm::Type::getInt32Ty(*context_), 0);
@@ -288,19 +303,19 @@ std::any IrEmitter::visitLoop(struct AsgLoop* node)
     builder_->CreateCondBr(cond, loopBlock, mergeBlock);
 
     builder_->SetInsertPoint(loopBlock);
-    node->body->accept(this);
+    visit(node->body);
     builder_->CreateBr(condBlock);
 
     builder_->SetInsertPoint(mergeBlock);
 
-    return {};
+    return nullptr;
 }
 
-std::any IrEmitter::visitComp(struct AsgComp* node)
+llvm::Value* IrEmitter::visitComp(AsgComp* node)
 {
     expected_ret_.push(RetType::Data);
-    auto* lhs = std::any_cast<llvm::Value*>(node->lhs->accept(this));
-    auto* rhs = std::any_cast<llvm::Value*>(node->rhs->accept(this));
+    auto* lhs = visit(node->lhs);
+    auto* rhs = visit(node->rhs);
     expected_ret_.pop();
 
     llvm::Value* i1Val = nullptr;
@@ -330,41 +345,41 @@ std::any IrEmitter::visitComp(struct AsgComp* node)
     return builder_->CreateIntCast(i1Val, llvm::Type::getInt32Ty(*context_), false);
 }
 
-std::any IrEmitter::visitAddSub(struct AsgAddSub* node)
+llvm::Value* IrEmitter::visitAddSub(AsgAddSub* node)
 {
     TC_ASSERT(expected_ret_.top() == RetType::Data || expected_ret_.top() == RetType::CallParam);
-    auto* last = std::any_cast<llvm::Value*>(node->subexpressions[0].expression->accept(this));
+    auto* last = visit(node->subexpressions[0].expression);
     for (auto i = 1; i < node->subexpressions.size(); i++) {
-        auto* curr = std::any_cast<llvm::Value*>(node->subexpressions[i].expression->accept(this));
+        auto* curr = visit(node->subexpressions[i].expression);
         if (node->subexpressions[i].leadingOp == AsgAddSub::Operator::Add) {
             last = builder_->CreateAdd(last, curr);
         } else {
             last = builder_->CreateSub(last, curr);
         }
     }
-    return (llvm::Value*)last;
+    return last;
 }
 
-std::any IrEmitter::visitMulDiv(struct AsgMulDiv* node)
+llvm::Value* IrEmitter::visitMulDiv(AsgMulDiv* node)
 {
     TC_ASSERT(expected_ret_.top() == RetType::Data || expected_ret_.top() == RetType::CallParam);
-    auto* last = std::any_cast<llvm::Value*>(node->subexpressions[0].expression->accept(this));
+    auto* last = visit(node->subexpressions[0].expression);
     for (auto i = 1; i < node->subexpressions.size(); i++) {
-        auto* curr = std::any_cast<llvm::Value*>(node->subexpressions[i].expression->accept(this));
+        auto* curr = visit(node->subexpressions[i].expression);
         if (node->subexpressions[i].leadingOp == AsgMulDiv::Operator::Mul) {
             last = builder_->CreateMul(last, curr);
         } else {
             last = builder_->CreateSDiv(last, curr);
         }
     }
-    return (llvm::Value*)last;
+    return last;
 }
 
-std::any IrEmitter::visitFieldAccess(struct AsgFieldAccess* node)
+llvm::Value* IrEmitter::visitFieldAccess(AsgFieldAccess* node)
 {
     expected_ret_.push(RetType::Ptr);
 
-    auto* accessed = std::any_cast<llvm::Value*>(node->accessed->accept(this));
+    auto* accessed = visit(node->accessed);
 
     expected_ret_.pop();
 
@@ -384,15 +399,15 @@ std::any IrEmitter::visitFieldAccess(struct AsgFieldAccess* node)
         return elemPtr;
     }
 
-    return (llvm::Value*)builder_->CreateLoad(
+    return builder_->CreateLoad(
         st->getFieldType(node->field)->getLLVMType(*context_, curr_function_->getAddressSpace()),
         elemPtr);
 }
 
-std::any IrEmitter::visitIndexing(struct AsgIndexing* node)
+llvm::Value* IrEmitter::visitIndexing(AsgIndexing* node)
 {
     expected_ret_.push(RetType::Ptr);
-    auto* indexed = std::any_cast<llvm::Value*>(node->indexed->accept(this));
+    auto* indexed = visit(node->indexed);
     expected_ret_.pop();
 
     auto indexedType = node->indexed->exprType;
@@ -414,9 +429,9 @@ std::any IrEmitter::visitIndexing(struct AsgIndexing* node)
             builder_->CreateLoad(
                 llvm::PointerType::get(*context_, curr_function_->getAddressSpace()),
                 indexed),
-            std::any_cast<llvm::Value*>(node->indexes[0]->accept(this)));
+            visit(node->indexes[0]));
     } else {
-        currGepIdx[1] = std::any_cast<llvm::Value*>(node->indexes[0]->accept(this));
+        currGepIdx[1] = visit(node->indexes[0]);
         lastGEP = builder_->CreateInBoundsGEP(
             indexedType->getLLVMType(*context_, curr_function_->getAddressSpace()),
             indexed,
@@ -429,7 +444,7 @@ std::any IrEmitter::visitIndexing(struct AsgIndexing* node)
         if (!indexedType) {
             std::cerr << "invalid indexing\n";
         }
-        currGepIdx[1] = std::any_cast<llvm::Value*>(node->indexes[i]->accept(this));
+        currGepIdx[1] = visit(node->indexes[i]);
         lastGEP = builder_->CreateGEP(
             indexedType->getLLVMType(*context_, curr_function_->getAddressSpace()),
             lastGEP,
@@ -440,14 +455,14 @@ std::any IrEmitter::visitIndexing(struct AsgIndexing* node)
     expected_ret_.pop();
 
     if (expected_ret_.top() == RetType::Data) {
-        return (llvm::Value*)builder_->CreateLoad(
+        return builder_->CreateLoad(
             indexedType->getLLVMType(*context_, curr_function_->getAddressSpace()),
             lastGEP);
     }
-    return (llvm::Value*)lastGEP;
+    return lastGEP;
 }
 
-std::any IrEmitter::visitOpDeref(struct AsgOpDeref* node)
+llvm::Value* IrEmitter::visitOpDeref(AsgOpDeref* node)
 {
     auto derefCount = node->derefCount;
 
@@ -456,7 +471,7 @@ std::any IrEmitter::visitOpDeref(struct AsgOpDeref* node)
     }
 
     expected_ret_.push(RetType::Data);
-    auto* lastLoad = std::any_cast<llvm::Value*>(node->expression->accept(this));
+    auto* lastLoad = visit(node->expression);
     expected_ret_.pop();
 
     auto exprType = node->expression->exprType;
@@ -477,12 +492,12 @@ std::any IrEmitter::visitOpDeref(struct AsgOpDeref* node)
     return lastLoad;
 }
 
-std::any IrEmitter::visitOpRef(struct AsgOpRef* node)
+llvm::Value* IrEmitter::visitOpRef(AsgOpRef* node)
 {
     llvm::Value* val = nullptr;
 
-    if (auto* variable = dynamic_cast<AsgVariable*>(node->value.get())) {
-        val = findAlloca(variable->name);
+    if (auto* variable = node->value->as<AsgVariable>()) {
+        val = allocas_[variable->slot];
     } else {
         std::cerr << "unexpected reference in " << node->function->name << "\n";
     }
@@ -490,12 +505,12 @@ std::any IrEmitter::visitOpRef(struct AsgOpRef* node)
     return val;
 }
 
-std::any IrEmitter::visitVariable(struct AsgVariable* node)
+llvm::Value* IrEmitter::visitVariable(AsgVariable* node)
 {
     if (expected_ret_.top() == RetType::Ptr) {
-        return (llvm::Value*)findAlloca(node->name);
+        return allocas_[node->slot];
     } else if (node->exprType->as<ArrayType>() && expected_ret_.top() == RetType::CallParam) {
-        auto* alloca = findAlloca(node->name);
+        auto* alloca = allocas_[node->slot];
         auto* constZero = llvm::ConstantInt::getSigned(llvm::Type::getInt64Ty(*context_), 0);
         std::vector<llvm::Value*> ids;
         auto currType = node->exprType;
@@ -503,46 +518,41 @@ std::any IrEmitter::visitVariable(struct AsgVariable* node)
             ids.push_back(constZero);
             currType = currType->as<ArrayType>()->getIndexed();
         }
-        return (llvm::Value*)builder_->CreateInBoundsGEP(
+        return builder_->CreateInBoundsGEP(
             node->exprType->getLLVMType(*context_, curr_function_->getAddressSpace()),
             alloca,
             ids);
     }
-    return (llvm::Value*)builder_->CreateLoad(
+    return builder_->CreateLoad(
         node->exprType->getLLVMType(*context_, curr_function_->getAddressSpace()),
-        findAlloca(node->name));
+        allocas_[node->slot]);
 }
 
-std::any IrEmitter::visitCall(struct AsgCall* node)
+llvm::Value* IrEmitter::visitCall(AsgCall* node)
 {
     expected_ret_.push(RetType::CallParam);
-    auto* callee = module_->getFunction(node->functionName);
+    auto* callee = module_->getFunction(node->functionName.str());
 
     std::vector<llvm::Value*> args;
     for (auto& expr : node->arguments) {
-        args.push_back(std::any_cast<llvm::Value*>(expr->accept(this)));
+        args.push_back(visit(expr));
     }
 
     expected_ret_.pop();
-    return (llvm::Value*)builder_->CreateCall(callee, args);
-}
-
-std::any IrEmitter::visitIntLiteral(struct AsgIntLiteral* node)
-{
-    return (llvm::Value*)llvm::ConstantInt::getSigned(llvm::Type::getInt32Ty(*context_), node->value);
+    auto* call = builder_->CreateCall(callee, args);
+    if (node->callee->origRetType) {
+        call->addParamAttr(0, llvm::Attribute::getWithStructRetType(
+                                  *context_, node->callee->origRetType->getLLVMType(*context_, 0)));
+    }
+    return call;
 }
 
-llvm::AllocaInst* IrEmitter::findAlloca(const std::string& name) const
+llvm::Value* IrEmitter::visitIntLiteral(AsgIntLiteral* node)
 {
-    for (auto scope = scopes_.rbegin(); scope != scopes_.rend(); scope++) {
-        if (scope->find(name) != scope->end()) {
-            return scope->at(name);
-        }
-    }
-    return nullptr;
+    return llvm::ConstantInt::getSigned(llvm::Type::getInt32Ty(*context_), node->value);
 }
 
-llvm::AllocaInst* IrEmitter::makeAlloca(const std::string& name, llvm::Type* type)
+llvm::AllocaInst* IrEmitter::makeAlloca(llvm::StringRef name, llvm::Type* type)
 {
     llvm::IRBuilder<> builder{
         &curr_function_->getEntryBlock(),
@@ -1,18 +1,22 @@
 #ifndef TINYC_IREMITTER_H
 #define TINYC_IREMITTER_H
 
-#include "asg/AsgNode.h"
 #include "asg/AsgVisitor.h"
 #include "pipeline/PipelineStage.h"
+#include "symbols/TypeLib.h"
 
-class IrEmitter : private AsgVisitorBase,
+class IrEmitter : private AsgVisitor<IrEmitter, llvm::Value*>,
                   public PipeModifierBase {
 public:
-    IrEmitter(std::string moduleName, bool optimize);
+    IrEmitter(std::string moduleName, TypeLibrary& types, const llvm::TargetMachine& targetMachine);
+    IrEmitter(std::string moduleName, TypeLibrary& types, const llvm::TargetMachine& targetMachine, llvm::LLVMContext& context);
 
     std::any modify(std::any data) override;
+    std::string_view getName() const override;
 
 private:
+    friend class AsgVisitor<IrEmitter, llvm::Value*>;
+
     enum class RetType {
         Ptr,
         Data,
@@ -20,40 +24,42 @@ private:
         Undef
     };
 
-    std::any visitStatementList(struct AsgStatementList* node) override;
-    std::any visitStructDefinition(struct AsgStructDefinition* node) override;
-    std::any visitFunctionDefinition(struct AsgFunctionDefinition* node) override;
-    std::any visitVariableDefinition(struct AsgVariableDefinition* node) override;
-    std::any visitReturn(struct AsgReturn* node) override;
-    std::any visitAssignment(struct AsgAssignment* node) override;
-    std::any visitConditional(struct AsgConditional* node) override;
-    std::any visitLoop(struct AsgLoop* node) override;
-
-    std::any visitComp(struct AsgComp* node) override;
-    std::any visitAddSub(struct AsgAddSub* node) override;
-    std::any visitMulDiv(struct AsgMulDiv* node) override;
-    std::any visitFieldAccess(struct AsgFieldAccess* node) override;
-    std::any visitIndexing(struct AsgIndexing* node) override;
-    std::any visitOpDeref(struct AsgOpDeref* node) override;
-    std::any visitOpRef(struct AsgOpRef* node) override;
-    std::any visitVariable(struct AsgVariable* node) override;
-    std::any visitCall(struct AsgCall* node) override;
-    std::any visitIntLiteral(struct AsgIntLiteral* node) override;
-
-    llvm::AllocaInst* findAlloca(const std::string& name) const;
-    llvm::AllocaInst* makeAlloca(const std::string& name, llvm::Type* type);
-
-    std::unique_ptr<llvm::LLVMContext> context_;
+    llvm::Value* visitStatementList(AsgStatementList* node);
+    llvm::Value* visitStructDefinition(AsgStructDefinition* node);
+    llvm::Value* visitFunctionDefinition(AsgFunctionDefinition* node);
+    llvm::Value* visitVariableDefinition(AsgVariableDefinition* node);
+    llvm::Value* visitReturn(AsgReturn* node);
+    llvm::Value* visitAssignment(AsgAssignment* node);
+    llvm::Value* visitConditional(AsgConditional* node);
+    llvm::Value* visitLoop(AsgLoop* node);
+
+    llvm::Value* visitComp(AsgComp* node);
+    llvm::Value* visitAddSub(AsgAddSub* node);
+    llvm::Value* visitMulDiv(AsgMulDiv* node);
+    llvm::Value* visitFieldAccess(AsgFieldAccess* node);
+    llvm::Value* visitIndexing(AsgIndexing* node);
+    llvm::Value* visitOpDeref(AsgOpDeref* node);
+    llvm::Value* visitOpRef(AsgOpRef* node);
+    llvm::Value* visitVariable(AsgVariable* node);
+    llvm::Value* visitCall(AsgCall* node);
+    llvm::Value* visitIntLiteral(AsgIntLiteral* node);
+
+    llvm::AllocaInst* makeAlloca(llvm::StringRef name, llvm::Type* type);
+
+    TypeLibrary& types_;
+    const llvm::TargetMachine& target_machine_;
+
+    std::unique_ptr<llvm::LLVMContext> own_context_;
+    llvm::LLVMContext* context_ = nullptr;
     std::unique_ptr<llvm::Module> module_;
     std::unique_ptr<llvm::IRBuilder<>> builder_;
 
-    std::deque<std::unordered_map<std::string, llvm::AllocaInst*>> scopes_;
+    std::vector<llvm::AllocaInst*> allocas_;
     llvm::Function* curr_function_ = nullptr;
 
     std::stack<RetType> expected_ret_;
 
     std::string module_name_;
-    bool optimize_;
 
     bool ok_ = true;
 };
@@ -0,0 +1,92 @@
+#include "IrOptimizer.h"
+
+#include "prof/Trace.h"
+
+static std::string getIrUnitName(const llvm::Any& ir)
+{
+    if (llvm::any_isa<const llvm::Function*>(ir)) {
+        return llvm::any_cast<const llvm::Function*>(ir)->getName().str();
+    }
+    if (llvm::any_isa<const llvm::Module*>(ir)) {
+        return llvm::any_cast<const llvm::Module*>(ir)->getName().str();
+    }
+    if (llvm::any_isa<const llvm::Loop*>(ir)) {
+        return llvm::any_cast<const llvm::Loop*>(ir)->getName().str();
+    }
+    if (llvm::any_isa<const llvm::LazyCallGraph::SCC*>(ir)) {
+        return llvm::any_cast<const llvm::LazyCallGraph::SCC*>(ir)->getName();
+    }
+    return {};
+}
+
+static void registerTraceCallbacks(llvm::PassInstrumentationCallbacks& callbacks)
+{
+    callbacks.registerBeforeNonSkippedPassCallback([](llvm::StringRef pass, llvm::Any ir) {
+        traceBegin("pass", pass, getIrUnitName(ir));
+    });
+    callbacks.registerAfterPassCallback([](llvm::StringRef, llvm::Any, const llvm::PreservedAnalyses&) {
+        traceEnd();
+    });
+    callbacks.registerAfterPassInvalidatedCallback([](llvm::StringRef, const llvm::PreservedAnalyses&) {
+        traceEnd();
+    });
+    callbacks.registerBeforeAnalysisCallback([](llvm::StringRef analysis, llvm::Any ir) {
+        traceBegin("analysis", analysis, getIrUnitName(ir));
+    });
+    callbacks.registerAfterAnalysisCallback([](llvm::StringRef, llvm::Any) {
+        traceEnd();
+    });
+}
+
+IrOptimizer::IrOptimizer(llvm::TargetMachine& targetMachine, llvm::OptimizationLevel level, std::string passes, Phase phase)
+    : target_machine_(targetMachine)
+    , level_(level)
+    , passes_(std::move(passes))
+    , phase_(phase)
+{
+}
+
+std::any IrOptimizer::modify(std::any data)
+{
+    if (data.type() != typeid(llvm::Module*)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to IrOptimizer -- expected llvm::Module*");
+        return {};
+    }
+    std::unique_ptr<llvm::Module> module{std::any_cast<llvm::Module*>(data)};
+
+    llvm::LoopAnalysisManager LAM;
+    llvm::FunctionAnalysisManager FAM;
+    llvm::CGSCCAnalysisManager CGAM;
+    llvm::ModuleAnalysisManager MAM;
+    llvm::PassInstrumentationCallbacks PIC;
+    if (traceEnabled()) {
+        registerTraceCallbacks(PIC);
+    }
+    llvm::PassBuilder PB{&target_machine_, llvm::PipelineTuningOptions{}, llvm::None, &PIC};
+    PB.registerModuleAnalyses(MAM);
+    PB.registerCGSCCAnalyses(CGAM);
+    PB.registerFunctionAnalyses(FAM);
+    PB.registerLoopAnalyses(LAM);
+    PB.crossRegisterProxies(LAM, FAM, CGAM, MAM);
+    llvm::ModulePassManager MPM;
+    if (!passes_.empty()) {
+        if (auto err = PB.parsePassPipeline(MPM, passes_)) {
+            TC_LOG_ERROR("invalid pass pipeline {} -- {}", passes_, llvm::toString(std::move(err)));
+            return {};
+        }
+    } else if (phase_ == Phase::PreLink) {
+        MPM = PB.buildLTOPreLinkDefaultPipeline(level_);
+    } else if (phase_ == Phase::Link) {
+        MPM = PB.buildLTODefaultPipeline(level_, nullptr);
+    } else {
+        MPM = PB.buildPerModuleDefaultPipeline(level_);
+    }
+    MPM.run(*module, MAM);
+
+    return module.release();
+}
+
+std::string_view IrOptimizer::getName() const
+{
+    return "optimization";
+}
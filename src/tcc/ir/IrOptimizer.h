@@ -0,0 +1,26 @@
+#ifndef TINYC_IROPTIMIZER_H
+#define TINYC_IROPTIMIZER_H
+
+#include "pipeline/PipelineStage.h"
+
+class IrOptimizer : public PipeModifierBase {
+public:
+    enum class Phase {
+        PerModule,
+        PreLink,
+        Link
+    };
+
+    IrOptimizer(llvm::TargetMachine& targetMachine, llvm::OptimizationLevel level, std::string passes, Phase phase);
+
+    std::any modify(std::any data) override;
+    std::string_view getName() const override;
+
+private:
+    llvm::TargetMachine& target_machine_;
+    llvm::OptimizationLevel level_;
+    std::string passes_;
+    Phase phase_;
+};
+
+#endif
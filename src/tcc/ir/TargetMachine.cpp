@@ -0,0 +1,61 @@
+#include "TargetMachine.h"
+
+static llvm::CodeGenOpt::Level getCodeGenOptLevel(llvm::OptimizationLevel level)
+{
+    if (level == llvm::OptimizationLevel::O0) {
+        return llvm::CodeGenOpt::None;
+    }
+    if (level == llvm::OptimizationLevel::O1) {
+        return llvm::CodeGenOpt::Less;
+    }
+    if (level == llvm::OptimizationLevel::O3) {
+        return llvm::CodeGenOpt::Aggressive;
+    }
+    return llvm::CodeGenOpt::Default;
+}
+
+std::unique_ptr<llvm::TargetMachine> createTargetMachine(const TargetSpec& spec, llvm::OptimizationLevel level)
+{
+    auto triple = spec.triple.empty() ? llvm::sys::getDefaultTargetTriple() : llvm::Triple::normalize(spec.triple);
+    auto cpu = spec.cpu;
+    llvm::SubtargetFeatures features;
+
+    if (cpu == "native") {
+        if (llvm::Triple{triple}.getArch() != llvm::Triple{llvm::sys::getProcessTriple()}.getArch()) {
+            TC_LOG_ERROR("--mcpu=native can not be used with foreign target {}", triple);
+            return nullptr;
+        }
+        cpu = llvm::sys::getHostCPUName().str();
+        llvm::StringMap<bool> hostFeatures;
+        if (llvm::sys::getHostCPUFeatures(hostFeatures)) {
+            for (const auto& feature : hostFeatures) {
+                features.AddFeature(feature.first(), feature.second);
+            }
+        }
+    }
+    for (const auto& feature : llvm::SubtargetFeatures{spec.features}.getFeatures()) {
+        features.AddFeature(feature);
+    }
+
+    std::string error;
+    const auto* target = llvm::TargetRegistry::lookupTarget(triple, error);
+    if (!target) {
+        TC_LOG_ERROR("can not find target {} -- {}", triple, error);
+        return nullptr;
+    }
+
+    std::unique_ptr<llvm::TargetMachine> targetMachine{target->createTargetMachine(
+        triple,
+        cpu,
+        features.getString(),
+        llvm::TargetOptions{},
+        llvm::Reloc::PIC_,
+        llvm::None,
+        getCodeGenOptLevel(level))};
+
+    if (!targetMachine) {
+        TC_LOG_ERROR("can not create target machine for {} with cpu {}", triple, cpu);
+        return nullptr;
+    }
+    return targetMachine;
+}
@@ -0,0 +1,12 @@
+#ifndef TINYC_TARGETMACHINE_H
+#define TINYC_TARGETMACHINE_H
+
+struct TargetSpec {
+    std::string triple;
+    std::string cpu = "generic";
+    std::string features;
+};
+
+std::unique_ptr<llvm::TargetMachine> createTargetMachine(const TargetSpec& spec, llvm::OptimizationLevel level);
+
+#endif
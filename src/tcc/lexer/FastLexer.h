@@ -0,0 +1,26 @@
+#ifndef TINYC_FASTLEXER_H
+#define TINYC_FASTLEXER_H
+
+#include "Token.h"
+
+// Hand written lexer for the token set of grammar/TinyC.g4, produces the whole token array in one pass.
+class FastLexer {
+public:
+    explicit FastLexer(llvm::StringRef source);
+
+    std::vector<Token> tokenize();
+    bool hasErrors() const;
+
+private:
+    Token::Kind lexIdentifier();
+    Token::Kind lexPunctuation();
+    bool accept(char c);
+
+    llvm::StringRef source_;
+    size_t position_ = 0;
+    uint32_t line_ = 1;
+    size_t line_start_ = 0;
+    bool has_errors_ = false;
+};
+
+#endif
@@ -0,0 +1,117 @@
+#include "FastTokenSource.h"
+
+#include "TinyCLexer.h"
+
+static size_t getTokenType(Token::Kind kind)
+{
+    switch (kind) {
+    case Token::Kind::Eof:
+        return antlr4::Token::EOF;
+    case Token::Kind::Return:
+        return TinyCLexer::RETURN;
+    case Token::Kind::If:
+        return TinyCLexer::IF;
+    case Token::Kind::Else:
+        return TinyCLexer::ELSE;
+    case Token::Kind::While:
+        return TinyCLexer::WHILE;
+    case Token::Kind::For:
+        return TinyCLexer::FOR;
+    case Token::Kind::Struct:
+        return TinyCLexer::STRUCT;
+    case Token::Kind::Identifier:
+        return TinyCLexer::IDENTIFIER;
+    case Token::Kind::IntLiteral:
+        return TinyCLexer::INT_LITERAL;
+    case Token::Kind::Comma:
+        return TinyCLexer::COMMA;
+    case Token::Kind::Semicolon:
+        return TinyCLexer::SEMICOLON;
+    case Token::Kind::LBrace:
+        return TinyCLexer::L_BRACE;
+    case Token::Kind::RBrace:
+        return TinyCLexer::R_BRACE;
+    case Token::Kind::LParan:
+        return TinyCLexer::L_PARAN;
+    case Token::Kind::RParan:
+        return TinyCLexer::R_PARAN;
+    case Token::Kind::LBrack:
+        return TinyCLexer::L_BRACK;
+    case Token::Kind::RBrack:
+        return TinyCLexer::R_BRACK;
+    case Token::Kind::Asterisk:
+        return TinyCLexer::ASTERISK;
+    case Token::Kind::Equal:
+        return TinyCLexer::EQUAL;
+    case Token::Kind::Plus:
+        return TinyCLexer::PLUS;
+    case Token::Kind::Minus:
+        return TinyCLexer::MINUS;
+    case Token::Kind::Slash:
+        return TinyCLexer::SLASH;
+    case Token::Kind::Ampersand:
+        return TinyCLexer::AMPERSAND;
+    case Token::Kind::Dot:
+        return TinyCLexer::DOT;
+    case Token::Kind::Arrow:
+        return TinyCLexer::ARROW;
+    case Token::Kind::EqualEqual:
+        return TinyCLexer::EQUALEQUAL;
+    case Token::Kind::NotEqual:
+        return TinyCLexer::NOTEQUAL;
+    case Token::Kind::Less:
+        return TinyCLexer::LESS;
+    case Token::Kind::LessEqual:
+        return TinyCLexer::LESSEQUAL;
+    case Token::Kind::Greater:
+        return TinyCLexer::GREATER;
+    case Token::Kind::GreaterEqual:
+        return TinyCLexer::GREATEREQUAL;
+    }
+    TC_ASSERT_FAIL("unknown token kind");
+    return antlr4::Token::INVALID_TYPE;
+}
+
+FastTokenSource::FastTokenSource(std::vector<Token> tokens, antlr4::CharStream* input)
+    : tokens_(std::move(tokens))
+    , input_(input)
+{
+}
+
+std::unique_ptr<antlr4::Token> FastTokenSource::nextToken()
+{
+    const auto& token = tokens_[next_];
+    auto stop = (size_t)token.offset + token.length - 1;
+
+    // the parser keeps asking for EOF once the end is reached
+    if (next_ + 1 < tokens_.size()) {
+        next_++;
+    }
+
+    return getTokenFactory()->create({this, input_}, getTokenType(token.kind), {}, antlr4::Token::DEFAULT_CHANNEL, token.offset, stop, token.line, token.column);
+}
+
+size_t FastTokenSource::getLine() const
+{
+    return tokens_[next_].line;
+}
+
+size_t FastTokenSource::getCharPositionInLine()
+{
+    return tokens_[next_].column;
+}
+
+antlr4::CharStream* FastTokenSource::getInputStream()
+{
+    return input_;
+}
+
+std::string FastTokenSource::getSourceName()
+{
+    return input_->getSourceName();
+}
+
+antlr4::TokenFactory<antlr4::CommonToken>* FastTokenSource::getTokenFactory()
+{
+    return antlr4::CommonTokenFactory::DEFAULT.get();
+}
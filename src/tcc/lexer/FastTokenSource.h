@@ -0,0 +1,25 @@
+#ifndef TINYC_FASTTOKENSOURCE_H
+#define TINYC_FASTTOKENSOURCE_H
+
+#include "Token.h"
+#include "antlr4-runtime.h"
+
+// Replays tokens of the FastLexer to the generated parser in place of TinyCLexer.
+class FastTokenSource : public antlr4::TokenSource {
+public:
+    FastTokenSource(std::vector<Token> tokens, antlr4::CharStream* input);
+
+    std::unique_ptr<antlr4::Token> nextToken() override;
+    size_t getLine() const override;
+    size_t getCharPositionInLine() override;
+    antlr4::CharStream* getInputStream() override;
+    std::string getSourceName() override;
+    antlr4::TokenFactory<antlr4::CommonToken>* getTokenFactory() override;
+
+private:
+    std::vector<Token> tokens_;
+    antlr4::CharStream* input_;
+    size_t next_ = 0;
+};
+
+#endif
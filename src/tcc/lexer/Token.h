@@ -0,0 +1,46 @@
+#ifndef TINYC_TOKEN_H
+#define TINYC_TOKEN_H
+
+struct Token {
+    enum class Kind : uint8_t {
+        Eof,
+        Return,
+        If,
+        Else,
+        While,
+        For,
+        Struct,
+        Identifier,
+        IntLiteral,
+        Comma,
+        Semicolon,
+        LBrace,
+        RBrace,
+        LParan,
+        RParan,
+        LBrack,
+        RBrack,
+        Asterisk,
+        Equal,
+        Plus,
+        Minus,
+        Slash,
+        Ampersand,
+        Dot,
+        Arrow,
+        EqualEqual,
+        NotEqual,
+        Less,
+        LessEqual,
+        Greater,
+        GreaterEqual
+    };
+
+    Kind kind;
+    uint32_t offset;
+    uint32_t length;
+    uint32_t line;
+    uint32_t column;
+};
+
+#endif
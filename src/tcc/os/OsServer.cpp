@@ -0,0 +1,261 @@
+#include "OsServer.h"
+
+#if defined(TC_LINUX)
+#include <csignal>
+#include <cstring>
+#include <sys/socket.h>
+#include <sys/stat.h>
+#include <sys/un.h>
+#include <unistd.h>
+#endif
+
+#if defined(TC_WINDOWS)
+
+int osServe(const std::string& socketPath, const ServerHandler& handler)
+{
+    TC_UNUSED(socketPath);
+    TC_UNUSED(handler);
+    TC_LOG_ERROR("server mode is not supported on this platform");
+    return EXIT_FAILURE;
+}
+
+std::optional<int> osForward(const std::string& socketPath, const std::vector<std::string>& args)
+{
+    TC_UNUSED(socketPath);
+    TC_UNUSED(args);
+    return std::nullopt;
+}
+
+#elif defined(TC_LINUX)
+
+static constexpr int forwarded_fds[] = {STDOUT_FILENO, STDERR_FILENO};
+
+static bool writeAll(int fd, const char* data, size_t size)
+{
+    while (size > 0) {
+        auto written = write(fd, data, size);
+        if (written <= 0) {
+            return false;
+        }
+        data += written;
+        size -= written;
+    }
+    return true;
+}
+
+static bool readAll(int fd, char* data, size_t size)
+{
+    while (size > 0) {
+        auto received = read(fd, data, size);
+        if (received <= 0) {
+            return false;
+        }
+        data += received;
+        size -= received;
+    }
+    return true;
+}
+
+static std::optional<sockaddr_un> getAddress(const std::string& socketPath)
+{
+    sockaddr_un address{};
+    if (socketPath.size() >= sizeof(address.sun_path)) {
+        TC_LOG_ERROR("socket path {} is too long", socketPath);
+        return std::nullopt;
+    }
+    address.sun_family = AF_UNIX;
+    std::copy(socketPath.begin(), socketPath.end(), address.sun_path);
+    return address;
+}
+
+// only a socket left behind by a server that is gone may be replaced, a live server or any other file is kept
+static bool removeStaleSocket(const std::string& socketPath, const sockaddr_un& address)
+{
+    struct stat status {};
+    if (lstat(socketPath.c_str(), &status) != 0) {
+        return errno == ENOENT;
+    }
+    if (!S_ISSOCK(status.st_mode)) {
+        TC_LOG_ERROR("{} exists and is not a socket", socketPath);
+        return false;
+    }
+
+    int probe = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (probe < 0) {
+        TC_LOG_ERROR("can not create socket -- {}", std::strerror(errno));
+        return false;
+    }
+    auto live = connect(probe, (const sockaddr*)&address, sizeof(address)) == 0;
+    close(probe);
+    if (live) {
+        TC_LOG_ERROR("a server is already running on {}", socketPath);
+        return false;
+    }
+
+    if (unlink(socketPath.c_str()) != 0 && errno != ENOENT) {
+        TC_LOG_ERROR("can not remove stale socket {} -- {}", socketPath, std::strerror(errno));
+        return false;
+    }
+    return true;
+}
+
+static void handleRequest(int connection, const ServerHandler& handler)
+{
+    uint32_t size = 0;
+    iovec header{&size, sizeof(size)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(forwarded_fds))]{};
+    msghdr message{};
+    message.msg_iov = &header;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+
+    if (recvmsg(connection, &message, MSG_WAITALL) != sizeof(size)) {
+        return;
+    }
+    auto* cmsg = CMSG_FIRSTHDR(&message);
+    if (!cmsg || cmsg->cmsg_type != SCM_RIGHTS || cmsg->cmsg_len != CMSG_LEN(sizeof(forwarded_fds))) {
+        TC_LOG_WARN("dropping request without client stdout and stderr");
+        return;
+    }
+    int clientFds[std::size(forwarded_fds)];
+    std::memcpy(clientFds, CMSG_DATA(cmsg), sizeof(clientFds));
+
+    std::string payload(size, '\0');
+    std::vector<std::string> args;
+    if (readAll(connection, payload.data(), payload.size())) {
+        std::stringstream ss{payload};
+        for (std::string arg; std::getline(ss, arg, '\0');) {
+            args.push_back(std::move(arg));
+        }
+    }
+
+    int32_t exitCode = EXIT_FAILURE;
+    if (!args.empty() && chdir(args.front().c_str()) == 0) {
+        args.erase(args.begin());
+
+        int savedFds[std::size(forwarded_fds)];
+        std::cout.flush();
+        std::cerr.flush();
+        for (size_t i = 0; i < std::size(forwarded_fds); i++) {
+            savedFds[i] = dup(forwarded_fds[i]);
+            dup2(clientFds[i], forwarded_fds[i]);
+        }
+
+        exitCode = handler(args);
+
+        std::cout.flush();
+        std::cerr.flush();
+        llvm::outs().flush();
+        for (size_t i = 0; i < std::size(forwarded_fds); i++) {
+            dup2(savedFds[i], forwarded_fds[i]);
+            close(savedFds[i]);
+        }
+    }
+    for (auto fd : clientFds) {
+        close(fd);
+    }
+
+    TC_UNUSED(writeAll(connection, (const char*)&exitCode, sizeof(exitCode)));
+}
+
+int osServe(const std::string& socketPath, const ServerHandler& handler)
+{
+    auto address = getAddress(socketPath);
+    if (!address) {
+        return EXIT_FAILURE;
+    }
+
+    if (!removeStaleSocket(socketPath, *address)) {
+        return EXIT_FAILURE;
+    }
+
+    int listener = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (listener < 0) {
+        TC_LOG_ERROR("can not create socket -- {}", std::strerror(errno));
+        return EXIT_FAILURE;
+    }
+    if (bind(listener, (const sockaddr*)&*address, sizeof(*address)) != 0 || listen(listener, SOMAXCONN) != 0) {
+        TC_LOG_ERROR("can not listen on {} -- {}", socketPath, std::strerror(errno));
+        close(listener);
+        return EXIT_FAILURE;
+    }
+    TC_LOG_INFO("serving compile requests on {}", socketPath);
+
+    // clients may close their end of the forwarded stdout at any time, e.g. when piped into head
+    std::signal(SIGPIPE, SIG_IGN);
+
+    while (true) {
+        int connection = accept4(listener, nullptr, nullptr, SOCK_CLOEXEC);
+        if (connection < 0) {
+            if (errno == EINTR) {
+                continue;
+            }
+            TC_LOG_ERROR("can not accept connection -- {}", std::strerror(errno));
+            break;
+        }
+        handleRequest(connection, handler);
+        close(connection);
+    }
+
+    close(listener);
+    unlink(socketPath.c_str());
+    return EXIT_FAILURE;
+}
+
+std::optional<int> osForward(const std::string& socketPath, const std::vector<std::string>& args)
+{
+    auto address = getAddress(socketPath);
+    if (!address) {
+        return std::nullopt;
+    }
+
+    int connection = socket(AF_UNIX, SOCK_STREAM | SOCK_CLOEXEC, 0);
+    if (connection < 0) {
+        return std::nullopt;
+    }
+    if (connect(connection, (const sockaddr*)&*address, sizeof(*address)) != 0) {
+        close(connection);
+        return std::nullopt;
+    }
+
+    llvm::SmallString<256> cwd;
+    if (llvm::sys::fs::current_path(cwd)) {
+        close(connection);
+        return std::nullopt;
+    }
+
+    std::string payload{cwd.str()};
+    payload.push_back('\0');
+    for (const auto& arg : args) {
+        payload += arg;
+        payload.push_back('\0');
+    }
+
+    uint32_t size = payload.size();
+    iovec header{&size, sizeof(size)};
+    alignas(cmsghdr) char control[CMSG_SPACE(sizeof(forwarded_fds))]{};
+    msghdr message{};
+    message.msg_iov = &header;
+    message.msg_iovlen = 1;
+    message.msg_control = control;
+    message.msg_controllen = sizeof(control);
+    auto* cmsg = CMSG_FIRSTHDR(&message);
+    cmsg->cmsg_level = SOL_SOCKET;
+    cmsg->cmsg_type = SCM_RIGHTS;
+    cmsg->cmsg_len = CMSG_LEN(sizeof(forwarded_fds));
+    std::memcpy(CMSG_DATA(cmsg), forwarded_fds, sizeof(forwarded_fds));
+
+    int32_t exitCode = EXIT_FAILURE;
+    const auto ok = sendmsg(connection, &message, MSG_NOSIGNAL) == sizeof(size)
+                    && writeAll(connection, payload.data(), payload.size())
+                    && readAll(connection, (char*)&exitCode, sizeof(exitCode));
+    close(connection);
+
+    if (!ok) {
+        return std::nullopt;
+    }
+    return exitCode;
+}
+
+#endif
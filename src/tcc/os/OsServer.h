@@ -0,0 +1,9 @@
+#ifndef TINYC_OSSERVER_H
+#define TINYC_OSSERVER_H
+
+using ServerHandler = std::function<int(const std::vector<std::string>& args)>;
+
+int osServe(const std::string& socketPath, const ServerHandler& handler);
+std::optional<int> osForward(const std::string& socketPath, const std::vector<std::string>& args);
+
+#endif
@@ -0,0 +1,48 @@
+#include "OsStats.h"
+
+#if defined(TC_WINDOWS)
+#include <windows.h>
+#include <psapi.h>
+#elif defined(TC_LINUX)
+#include <sys/resource.h>
+#endif
+
+double osThreadCpuTimeMs()
+{
+#if defined(TC_WINDOWS)
+    FILETIME creation, exit, kernel, user;
+    if (!GetThreadTimes(GetCurrentThread(), &creation, &exit, &kernel, &user)) {
+        return 0;
+    }
+    auto toMs = [](const FILETIME& ft) {
+        return (double)((ULONGLONG)ft.dwHighDateTime << 32 | ft.dwLowDateTime) / 10000.0;
+    };
+    return toMs(kernel) + toMs(user);
+#elif defined(TC_LINUX)
+    rusage usage{};
+    if (getrusage(RUSAGE_THREAD, &usage) != 0) {
+        return 0;
+    }
+    auto toMs = [](const timeval& tv) {
+        return (double)tv.tv_sec * 1000.0 + (double)tv.tv_usec / 1000.0;
+    };
+    return toMs(usage.ru_utime) + toMs(usage.ru_stime);
+#endif
+}
+
+size_t osPeakRssKb()
+{
+#if defined(TC_WINDOWS)
+    PROCESS_MEMORY_COUNTERS counters{};
+    if (!GetProcessMemoryInfo(GetCurrentProcess(), &counters, sizeof(counters))) {
+        return 0;
+    }
+    return counters.PeakWorkingSetSize / 1024;
+#elif defined(TC_LINUX)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+    return (size_t)usage.ru_maxrss;
+#endif
+}
@@ -0,0 +1,7 @@
+#ifndef TINYC_OSSTATS_H
+#define TINYC_OSSTATS_H
+
+double osThreadCpuTimeMs();
+size_t osPeakRssKb();
+
+#endif
@@ -0,0 +1,544 @@
+#include "Parser.h"
+
+Parser::Parser(llvm::ArrayRef<Token> tokens, llvm::StringRef source)
+    : tokens_(tokens)
+    , source_(source)
+    , eof_{Token::Kind::Eof, (uint32_t)source.size(), 0, 1, 0}
+{
+    if (!tokens_.empty()) {
+        const auto& last = tokens_.back();
+        eof_ = {Token::Kind::Eof, last.offset + last.length, 0, last.line, last.column + last.length};
+    }
+}
+
+AsgNode* Parser::parse()
+{
+    auto node = std::make_unique<AsgStatementList>();
+    do {
+        if (check(Token::Kind::Struct) && check(Token::Kind::Identifier, 1) && check(Token::Kind::LBrace, 2)) {
+            node->statements.push_back(parseStructDef());
+        } else {
+            node->statements.push_back(parseFunctionDef());
+        }
+    } while (!check(Token::Kind::Eof));
+
+    if (!ok_) {
+        return nullptr;
+    }
+    return node.release();
+}
+
+std::unique_ptr<AsgNode> Parser::parseStructDef()
+{
+    auto node = std::make_unique<AsgStructDefinition>();
+    node->refLine = expect(Token::Kind::Struct, "'struct'").line;
+    node->name = getIdentifier(expect(Token::Kind::Identifier, "struct name"));
+    expect(Token::Kind::LBrace, "'{'");
+    do {
+        AsgStructDefinition::Field field;
+        field.refLine = peek().line;
+        field.type = parseType();
+        field.name = getIdentifier(expect(Token::Kind::Identifier, "field name"));
+        parseConstantIndexing(field.type);
+        expect(Token::Kind::Semicolon, "';'");
+        node->fields.push_back(std::move(field));
+    } while (!check(Token::Kind::RBrace) && !check(Token::Kind::Eof));
+    expect(Token::Kind::RBrace, "'}'");
+    expect(Token::Kind::Semicolon, "';'");
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseFunctionDef()
+{
+    auto node = std::make_unique<AsgFunctionDefinition>();
+    node->refLine = peek().line;
+    node->returnType = parseType();
+    node->name = getIdentifier(expect(Token::Kind::Identifier, "function name"));
+
+    expect(Token::Kind::LParan, "'('");
+    if (!check(Token::Kind::RParan)) {
+        do {
+            AsgFunctionDefinition::Parameter parameter;
+            parameter.type = parseType();
+            parameter.name = getIdentifier(expect(Token::Kind::Identifier, "parameter name"));
+            parseConstantIndexing(parameter.type);
+            node->parameters.push_back(std::move(parameter));
+        } while (accept(Token::Kind::Comma));
+    }
+    expect(Token::Kind::RParan, "')'");
+
+    if (!accept(Token::Kind::Semicolon)) {
+        node->body = parseStatements();
+    }
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseStatements()
+{
+    auto node = std::make_unique<AsgStatementList>();
+    node->refLine = expect(Token::Kind::LBrace, "'{'").line;
+
+    bool returned = false;
+    while (!check(Token::Kind::RBrace) && !check(Token::Kind::Eof)) {
+        auto statement = parseStatement();
+        // statements after a return are unreachable and dropped
+        if (!returned) {
+            returned = statement && statement->kind == AsgNode::Kind::Return;
+            node->statements.push_back(std::move(statement));
+        }
+    }
+    expect(Token::Kind::RBrace, "'}'");
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseStatement()
+{
+    switch (peek().kind) {
+    case Token::Kind::Return: {
+        auto node = parseReturnStatement();
+        expect(Token::Kind::Semicolon, "';'");
+        return node;
+    }
+    case Token::Kind::If:
+        return parseIfStatement();
+    case Token::Kind::While:
+        return parseWhileStatement();
+    case Token::Kind::For:
+        return parseForStatement();
+    case Token::Kind::LBrace:
+        return parseStatements();
+    default: {
+        auto node = parseExpression();
+        expect(Token::Kind::Semicolon, "';'");
+        return node;
+    }
+    }
+}
+
+std::unique_ptr<AsgNode> Parser::parseIfStatement()
+{
+    auto node = std::make_unique<AsgConditional>();
+    node->refLine = expect(Token::Kind::If, "'if'").line;
+    expect(Token::Kind::LParan, "'('");
+    node->condition = parseExpression();
+    expect(Token::Kind::RParan, "')'");
+    node->thenNode = parseStatement();
+    if (accept(Token::Kind::Else)) {
+        node->elseNode = parseStatement();
+    }
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseWhileStatement()
+{
+    auto node = std::make_unique<AsgLoop>();
+    node->refLine = expect(Token::Kind::While, "'while'").line;
+    expect(Token::Kind::LParan, "'('");
+    node->condition = parseExpression();
+    expect(Token::Kind::RParan, "')'");
+    node->body = parseStatement();
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseForStatement()
+{
+    auto line = expect(Token::Kind::For, "'for'").line;
+    expect(Token::Kind::LParan, "'('");
+    auto init = parseExpression();
+    expect(Token::Kind::Semicolon, "';'");
+    auto condition = parseExpression();
+    expect(Token::Kind::Semicolon, "';'");
+    auto step = parseExpression();
+    expect(Token::Kind::RParan, "')'");
+
+    auto loopBody = std::make_unique<AsgStatementList>();
+    loopBody->refLine = line;
+    loopBody->statements.push_back(parseStatement());
+    loopBody->statements.push_back(std::move(step));
+
+    auto loopNode = std::make_unique<AsgLoop>();
+    loopNode->refLine = line;
+    loopNode->condition = std::move(condition);
+    loopNode->body = std::move(loopBody);
+
+    auto node = std::make_unique<AsgStatementList>();
+    node->refLine = line;
+    node->statements.push_back(std::move(init));
+    node->statements.push_back(std::move(loopNode));
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseReturnStatement()
+{
+    auto node = std::make_unique<AsgReturn>();
+    node->refLine = expect(Token::Kind::Return, "'return'").line;
+    if (!check(Token::Kind::Semicolon)) {
+        node->value = parseExpression();
+    }
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseExpression()
+{
+    if (isVariableDecl()) {
+        return parseVariableDecl();
+    }
+
+    auto first = parseLeadingOperand();
+    if (!check(Token::Kind::Equal)) {
+        return parseCompExpression(std::move(first));
+    }
+
+    expect(Token::Kind::Equal, "'='");
+    auto node = std::make_unique<AsgAssignment>();
+    node->refLine = first.line;
+    node->assignable = std::move(first.node);
+    node->value = parseExpression();
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseVariableDecl()
+{
+    auto node = std::make_unique<AsgVariableDefinition>();
+    node->refLine = peek().line;
+    node->type = parseType();
+    node->name = getIdentifier(expect(Token::Kind::Identifier, "variable name"));
+    parseConstantIndexing(node->type);
+    if (accept(Token::Kind::Equal)) {
+        node->value = parseExpression();
+    }
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseCompExpression(Operand first)
+{
+    auto line = first.line;
+    auto lhs = parseAddSubExpr(std::move(first));
+
+    AsgComp::Operator op;
+    switch (peek().kind) {
+    case Token::Kind::EqualEqual:
+        op = AsgComp::Operator::Equals;
+        break;
+    case Token::Kind::NotEqual:
+        op = AsgComp::Operator::NotEquals;
+        break;
+    case Token::Kind::Less:
+        op = AsgComp::Operator::Less;
+        break;
+    case Token::Kind::LessEqual:
+        op = AsgComp::Operator::LessEquals;
+        break;
+    case Token::Kind::Greater:
+        op = AsgComp::Operator::Greater;
+        break;
+    case Token::Kind::GreaterEqual:
+        op = AsgComp::Operator::GreaterEquals;
+        break;
+    default:
+        return lhs;
+    }
+    position_++;
+
+    auto node = std::make_unique<AsgComp>();
+    node->refLine = line;
+    node->lhs = std::move(lhs);
+    node->rhs = parseAddSubExpr(parseLeadingOperand());
+    node->op = op;
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseAddSubExpr(Operand first)
+{
+    auto line = first.line;
+    auto lhs = parseMulDivExpr(std::move(first));
+    if (!check(Token::Kind::Plus) && !check(Token::Kind::Minus)) {
+        return lhs;
+    }
+
+    auto node = std::make_unique<AsgAddSub>();
+    node->refLine = line;
+    node->subexpressions.push_back({AsgAddSub::Operator::Add, std::move(lhs)});
+    while (check(Token::Kind::Plus) || check(Token::Kind::Minus)) {
+        auto op = check(Token::Kind::Minus) ? AsgAddSub::Operator::Sub : AsgAddSub::Operator::Add;
+        position_++;
+        node->subexpressions.push_back({op, parseMulDivExpr(parseLeadingOperand())});
+    }
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseMulDivExpr(Operand first)
+{
+    if (!check(Token::Kind::Asterisk) && !check(Token::Kind::Slash)) {
+        return std::move(first.node);
+    }
+
+    auto node = std::make_unique<AsgMulDiv>();
+    node->refLine = first.line;
+    node->subexpressions.push_back({AsgMulDiv::Operator::Mul, std::move(first.node)});
+    while (check(Token::Kind::Asterisk) || check(Token::Kind::Slash)) {
+        auto op = check(Token::Kind::Slash) ? AsgMulDiv::Operator::Div : AsgMulDiv::Operator::Mul;
+        position_++;
+        node->subexpressions.push_back({op, parseOperandDereference()});
+    }
+    return node;
+}
+
+Parser::Operand Parser::parseLeadingOperand()
+{
+    auto line = peek().line;
+    return {parseOperandDereference(), line};
+}
+
+std::unique_ptr<AsgNode> Parser::parseOperandDereference()
+{
+    auto line = peek().line;
+    size_t derefCount = 0;
+    while (accept(Token::Kind::Asterisk)) {
+        derefCount++;
+    }
+    if (derefCount == 0) {
+        return parseFieldAccess();
+    }
+
+    auto node = std::make_unique<AsgOpDeref>();
+    node->refLine = line;
+    node->derefCount = derefCount;
+    node->expression = parseFieldAccess();
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseFieldAccess()
+{
+    auto accessed = parseIndexedOperand();
+    while (check(Token::Kind::Dot) || check(Token::Kind::Arrow)) {
+        auto line = peek().line;
+        if (accept(Token::Kind::Arrow)) {
+            auto derefNode = std::make_unique<AsgOpDeref>();
+            derefNode->refLine = line;
+            derefNode->derefCount = 1;
+            derefNode->expression = std::move(accessed);
+            accessed = std::move(derefNode);
+        } else {
+            position_++;
+        }
+
+        auto accNode = std::make_unique<AsgFieldAccess>();
+        accNode->refLine = line;
+        accNode->field = getIdentifier(expect(Token::Kind::Identifier, "field name"));
+        accNode->accessed = std::move(accessed);
+
+        if (!check(Token::Kind::LBrack)) {
+            accessed = std::move(accNode);
+            continue;
+        }
+
+        auto indexingNode = std::make_unique<AsgIndexing>();
+        indexingNode->refLine = line;
+        indexingNode->indexed = std::move(accNode);
+        parseIndexing(indexingNode->indexes);
+        accessed = std::move(indexingNode);
+    }
+    return accessed;
+}
+
+std::unique_ptr<AsgNode> Parser::parseIndexedOperand()
+{
+    auto line = peek().line;
+    auto operand = parseOperand();
+    if (!check(Token::Kind::LBrack)) {
+        return operand;
+    }
+
+    auto node = std::make_unique<AsgIndexing>();
+    node->refLine = line;
+    node->indexed = std::move(operand);
+    parseIndexing(node->indexes);
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseOperand()
+{
+    switch (peek().kind) {
+    case Token::Kind::LParan: {
+        position_++;
+        auto node = parseExpression();
+        expect(Token::Kind::RParan, "')'");
+        return node;
+    }
+    case Token::Kind::IntLiteral:
+        return parseLiteral();
+    case Token::Kind::Ampersand: {
+        auto node = std::make_unique<AsgOpRef>();
+        node->refLine = peek().line;
+        position_++;
+        node->value = parseVariable();
+        return node;
+    }
+    case Token::Kind::Identifier:
+        if (check(Token::Kind::LParan, 1)) {
+            return parseCall();
+        }
+        return parseVariable();
+    default:
+        error(peek(), "expression");
+        return nullptr;
+    }
+}
+
+std::unique_ptr<AsgNode> Parser::parseCall()
+{
+    auto node = std::make_unique<AsgCall>();
+    node->refLine = peek().line;
+    node->functionName = getIdentifier(expect(Token::Kind::Identifier, "function name"));
+    expect(Token::Kind::LParan, "'('");
+    if (!check(Token::Kind::RParan)) {
+        do {
+            node->arguments.push_back(parseExpression());
+        } while (accept(Token::Kind::Comma));
+    }
+    expect(Token::Kind::RParan, "')'");
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseVariable()
+{
+    auto node = std::make_unique<AsgVariable>();
+    node->refLine = peek().line;
+    node->name = getIdentifier(expect(Token::Kind::Identifier, "variable name"));
+    return node;
+}
+
+std::unique_ptr<AsgNode> Parser::parseLiteral()
+{
+    const auto& token = expect(Token::Kind::IntLiteral, "integer literal");
+    auto node = std::make_unique<AsgIntLiteral>();
+    node->refLine = token.line;
+    if (source_.substr(token.offset, token.length).getAsInteger(10, node->value)) {
+        error(token, "integer literal in range");
+    }
+    return node;
+}
+
+TypeRef Parser::parseType()
+{
+    TypeRef type;
+    accept(Token::Kind::Struct);
+    type.name = getIdentifier(expect(Token::Kind::Identifier, "type name"));
+    while (accept(Token::Kind::Asterisk)) {
+        type.ptrDepth++;
+    }
+    return type;
+}
+
+void Parser::parseConstantIndexing(TypeRef& type)
+{
+    while (accept(Token::Kind::LBrack)) {
+        int size = -1;
+        if (check(Token::Kind::IntLiteral)) {
+            const auto& token = peek();
+            if (source_.substr(token.offset, token.length).getAsInteger(10, size)) {
+                error(token, "array size in range");
+            }
+            position_++;
+        }
+        type.dimensions.push_back(size);
+        expect(Token::Kind::RBrack, "']'");
+    }
+}
+
+void Parser::parseIndexing(std::vector<std::unique_ptr<AsgNode>>& indexes)
+{
+    while (accept(Token::Kind::LBrack)) {
+        indexes.push_back(parseExpression());
+        expect(Token::Kind::RBrack, "']'");
+    }
+}
+
+bool Parser::isVariableDecl() const
+{
+    // a declaration starts with a type followed by the variable name, "a * b" is ambiguous and, like in the
+    // ANTLR parser, taken as an expression unless the rest of the declaration only fits a declaration
+    if (check(Token::Kind::Struct)) {
+        return true;
+    }
+    if (!check(Token::Kind::Identifier)) {
+        return false;
+    }
+
+    size_t ahead = 1;
+    size_t ptrDepth = 0;
+    while (check(Token::Kind::Asterisk, ahead)) {
+        ahead++;
+        ptrDepth++;
+    }
+    if (!check(Token::Kind::Identifier, ahead++)) {
+        return false;
+    }
+    if (ptrDepth == 0) {
+        return true;
+    }
+
+    while (check(Token::Kind::LBrack, ahead)) {
+        if (check(Token::Kind::RBrack, ahead + 1)) {
+            return true;
+        }
+        if (!check(Token::Kind::IntLiteral, ahead + 1) || !check(Token::Kind::RBrack, ahead + 2)) {
+            return false;
+        }
+        ahead += 3;
+    }
+    return check(Token::Kind::Equal, ahead);
+}
+
+const Token& Parser::peek(size_t ahead) const
+{
+    auto position = position_ + ahead;
+    return position < tokens_.size() ? tokens_[position] : eof_;
+}
+
+bool Parser::check(Token::Kind kind, size_t ahead) const
+{
+    return peek(ahead).kind == kind;
+}
+
+bool Parser::accept(Token::Kind kind)
+{
+    if (!check(kind)) {
+        return false;
+    }
+    position_++;
+    return true;
+}
+
+const Token& Parser::expect(Token::Kind kind, std::string_view expected)
+{
+    const auto& token = peek();
+    if (token.kind != kind) {
+        error(token, expected);
+        return token;
+    }
+    position_++;
+    return token;
+}
+
+std::string Parser::getText(const Token& token) const
+{
+    return source_.substr(token.offset, token.length).str();
+}
+
+Identifier Parser::getIdentifier(const Token& token) const
+{
+    return Identifier::get(source_.substr(token.offset, token.length));
+}
+
+void Parser::error(const Token& token, std::string_view expected)
+{
+    if (ok_) {
+        auto text = token.kind == Token::Kind::Eof ? std::string{"<EOF>"} : getText(token);
+        TC_LOG_ERROR("at line {} -- unexpected '{}', expecting {}", token.line, text, expected);
+        ok_ = false;
+    }
+    // skip to the end, every following rule then fails without further diagnostics
+    position_ = tokens_.size();
+}
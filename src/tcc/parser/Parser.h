@@ -0,0 +1,64 @@
+#ifndef TINYC_PARSER_H
+#define TINYC_PARSER_H
+
+#include "asg/AsgNode.h"
+#include "lexer/Token.h"
+
+// Recursive descent parser for grammar/TinyC.g4, builds the same ASG as AstVisitor without a parse tree.
+class Parser {
+public:
+    // tokens do not need to end with Eof, so that a range of top level entities can be parsed on its own
+    Parser(llvm::ArrayRef<Token> tokens, llvm::StringRef source);
+
+    AsgNode* parse();
+
+private:
+    struct Operand {
+        std::unique_ptr<AsgNode> node;
+        uint32_t line;
+    };
+
+    std::unique_ptr<AsgNode> parseStructDef();
+    std::unique_ptr<AsgNode> parseFunctionDef();
+    std::unique_ptr<AsgNode> parseStatements();
+    std::unique_ptr<AsgNode> parseStatement();
+    std::unique_ptr<AsgNode> parseIfStatement();
+    std::unique_ptr<AsgNode> parseWhileStatement();
+    std::unique_ptr<AsgNode> parseForStatement();
+    std::unique_ptr<AsgNode> parseReturnStatement();
+
+    std::unique_ptr<AsgNode> parseExpression();
+    std::unique_ptr<AsgNode> parseVariableDecl();
+    std::unique_ptr<AsgNode> parseCompExpression(Operand first);
+    std::unique_ptr<AsgNode> parseAddSubExpr(Operand first);
+    std::unique_ptr<AsgNode> parseMulDivExpr(Operand first);
+    Operand parseLeadingOperand();
+    std::unique_ptr<AsgNode> parseOperandDereference();
+    std::unique_ptr<AsgNode> parseFieldAccess();
+    std::unique_ptr<AsgNode> parseIndexedOperand();
+    std::unique_ptr<AsgNode> parseOperand();
+    std::unique_ptr<AsgNode> parseCall();
+    std::unique_ptr<AsgNode> parseVariable();
+    std::unique_ptr<AsgNode> parseLiteral();
+
+    TypeRef parseType();
+    void parseConstantIndexing(TypeRef& type);
+    void parseIndexing(std::vector<std::unique_ptr<AsgNode>>& indexes);
+    bool isVariableDecl() const;
+
+    const Token& peek(size_t ahead = 0) const;
+    bool check(Token::Kind kind, size_t ahead = 0) const;
+    bool accept(Token::Kind kind);
+    const Token& expect(Token::Kind kind, std::string_view expected);
+    std::string getText(const Token& token) const;
+    Identifier getIdentifier(const Token& token) const;
+    void error(const Token& token, std::string_view expected);
+
+    llvm::ArrayRef<Token> tokens_;
+    llvm::StringRef source_;
+    Token eof_;
+    size_t position_ = 0;
+    bool ok_ = true;
+};
+
+#endif
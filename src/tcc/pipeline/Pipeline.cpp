@@ -23,17 +23,22 @@ void Pipeline::add(std::unique_ptr<PipeOutputBase> output)
     output_ = std::move(output);
 }
 
+void Pipeline::setTimeReport(TimeReport* report)
+{
+    time_report_ = report;
+}
+
 bool Pipeline::run()
 {
-    auto data = input_->produce();
+    auto data = measure(*input_, [&]() { return input_->produce(); });
     if (!data.has_value()) {
         return false;
     }
     for (auto& modifier : modifiers_) {
-        data = modifier->modify(data);
+        data = measure(*modifier, [&]() { return modifier->modify(std::move(data)); });
         if (!data.has_value()) {
             return false;
         }
     }
-    return output_->consume(data);
+    return measure(*output_, [&]() { return output_->consume(std::move(data)); });
 }
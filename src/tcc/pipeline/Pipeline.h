@@ -2,6 +2,8 @@
 #define TINYC_PIPELINE_H
 
 #include "PipelineStage.h"
+#include "prof/TimeReport.h"
+#include "prof/Trace.h"
 
 class Pipeline {
 public:
@@ -9,9 +11,24 @@ public:
     Pipeline& add(std::unique_ptr<PipeModifierBase> modifier);
     void add(std::unique_ptr<PipeOutputBase> output);
 
+    void setTimeReport(TimeReport* report);
+
     bool run();
 
 private:
+    template<typename F>
+    auto measure(const PipeStageBase& stage, F&& f)
+    {
+        TraceScope trace{"stage", stage.getName()};
+        std::optional<TimeReport::Scope> scope;
+        if (time_report_) {
+            scope.emplace(*time_report_, stage.getName());
+        }
+        return f();
+    }
+
+    TimeReport* time_report_ = nullptr;
+
     std::unique_ptr<PipeInputBase> input_;
     std::vector<std::unique_ptr<PipeModifierBase>> modifiers_;
     std::unique_ptr<PipeOutputBase> output_;
@@ -1,21 +1,21 @@
 #ifndef TINYC_PIPELINESTAGE_H
 #define TINYC_PIPELINESTAGE_H
 
-struct PipeInputBase {
-    virtual ~PipeInputBase() = default;
+struct PipeStageBase {
+    virtual ~PipeStageBase() = default;
 
-    virtual std::any produce() = 0;
+    virtual std::string_view getName() const = 0;
 };
 
-struct PipeModifierBase {
-    virtual ~PipeModifierBase() = default;
+struct PipeInputBase : PipeStageBase {
+    virtual std::any produce() = 0;
+};
 
+struct PipeModifierBase : PipeStageBase {
     virtual std::any modify(std::any data) = 0;
 };
 
-struct PipeOutputBase {
-    virtual ~PipeOutputBase() = default;
-
+struct PipeOutputBase : PipeStageBase {
     virtual bool consume(std::any data) = 0;
 };
 
@@ -1,39 +1,108 @@
 #include "FileReader.h"
 
+#include "lexer/FastLexer.h"
+#include "lexer/FastTokenSource.h"
 #include "TinyCLexer.h"
 #include "TinyCParser.h"
 
-FileReader::FileReader(std::string fileName)
+FileReader::FileReader(std::string fileName, bool fastLexer)
     : file_name_(std::move(fileName))
+    , fast_lexer_(fastLexer)
 {
 }
 
+// exercises every rule of the grammar, parsed once to fill the prediction caches shared by all parsers
+static constexpr std::string_view warm_up_source = R"(
+struct W { int a; struct W* next; int v[2]; };
+int f(int x, int* p, struct W w[]);
+int f(int x, int* p, struct W w[])
+{
+    int i = 0;
+    struct W* q = &w;
+    for (i = 0; i < x; i = i + 1) {
+        if (i == 1) { *p = w[i].v[0] * 2 / x; } else { x = q->a - f(x, &i, w); }
+    }
+    while (i >= 0) i = i - 1;
+    if (x <= 0) return x != 0;
+    return (x > 1) + q->next->v[1];
+}
+)";
+
 std::any FileReader::produce()
 {
-    std::ifstream file;
-    file.open(file_name_);
-    if (!file.is_open()) {
-        TC_LOG_CRITICAL("cant open file {}", file_name_);
+    auto file = llvm::MemoryBuffer::getFile(file_name_, false, false);
+    if (!file) {
+        TC_LOG_CRITICAL("cant open file {} -- {}", file_name_, file.getError().message());
+        return {};
+    }
+
+    auto unit = parse(std::move(*file));
+    if (!unit) {
         return {};
     }
+    return unit;
+}
+
+std::string_view FileReader::getName() const
+{
+    return "parse";
+}
+
+void FileReader::warmUp()
+{
+    static std::once_flag warmed;
+    std::call_once(warmed, [] {
+        FileReader reader{"warm-up", false};
+        TC_UNUSED(reader.parse(llvm::MemoryBuffer::getMemBuffer(warm_up_source, "warm-up", false)));
+    });
+}
+
+std::shared_ptr<ParsedUnit> FileReader::parse(std::unique_ptr<llvm::MemoryBuffer> buffer) const
+{
+    auto unit = std::make_shared<ParsedUnit>();
+    unit->input = std::make_unique<MappedCharStream>(std::move(buffer));
+    if (fast_lexer_) {
+        FastLexer lexer{unit->input->getBuffer()};
+        auto tokens = lexer.tokenize();
+        if (lexer.hasErrors()) {
+            return nullptr;
+        }
+        unit->lexer = std::make_unique<FastTokenSource>(std::move(tokens), unit->input.get());
+    } else {
+        unit->lexer = std::make_unique<TinyCLexer>(unit->input.get());
+    }
+    unit->tokens = std::make_unique<antlr4::CommonTokenStream>(unit->lexer.get());
+    unit->parser = std::make_unique<TinyCParser>(unit->tokens.get());
+    auto& parser = *unit->parser;
 
-    input_stream_ = std::make_unique<antlr4::ANTLRInputStream>(file);
-    lexer_ = std::make_unique<TinyCLexer>(input_stream_.get());
-    tokens_ = std::make_unique<antlr4::CommonTokenStream>(lexer_.get());
-    parser_ = std::make_unique<TinyCParser>(tokens_.get());
+    // SLL prediction is enough for almost all inputs, only when it fails is the input parsed again with full LL
+    // and the error listener, so that syntax errors are reported the same in both cases
+    auto* interpreter = parser.getInterpreter<antlr4::atn::ParserATNSimulator>();
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::SLL);
+    parser.removeErrorListeners();
+    parser.setErrorHandler(std::make_shared<antlr4::BailErrorStrategy>());
 
-    error_listener_ = std::make_unique<ErrorListener>();
+    try {
+        unit->tree = parser.translationUnit();
+        return unit;
+    } catch (const antlr4::ParseCancellationException&) {
+    }
 
-    parser_->removeErrorListeners();
-    parser_->addErrorListener(error_listener_.get());
+    ErrorListener errorListener;
 
-    auto* ret = parser_->translationUnit();
+    parser.reset();
+    parser.addErrorListener(&errorListener);
+    parser.setErrorHandler(std::make_shared<antlr4::DefaultErrorStrategy>());
+    interpreter->setPredictionMode(antlr4::atn::PredictionMode::LL);
 
-    if (error_listener_->hasErrors) {
-        return {};
+    unit->tree = parser.translationUnit();
+    parser.removeErrorListeners();
+
+    if (errorListener.hasErrors) {
+        return nullptr;
     }
 
-    return ret;
+    return unit;
 }
 
 void FileReader::ErrorListener::syntaxError(antlr4::Recognizer* recognizer, antlr4::Token* offendingSymbol, size_t line, size_t charPositionInLine, const std::string& msg, std::exception_ptr e)
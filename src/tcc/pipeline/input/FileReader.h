@@ -1,15 +1,17 @@
 #ifndef TINYC_ASTGENERATOR_H
 #define TINYC_ASTGENERATOR_H
 
+#include "ParsedUnit.h"
 #include "pipeline/PipelineStage.h"
-#include "TinyCLexer.h"
-#include "TinyCParser.h"
 
 class FileReader : public PipeInputBase {
 public:
-    explicit FileReader(std::string fileName);
+    FileReader(std::string fileName, bool fastLexer);
 
     std::any produce() override;
+    std::string_view getName() const override;
+
+    static void warmUp();
 
 private:
     struct ErrorListener : public antlr4::ANTLRErrorListener {
@@ -30,14 +32,10 @@ private:
         bool hasErrors = false;
     };
 
-    std::string file_name_;
-
-    std::unique_ptr<antlr4::ANTLRInputStream> input_stream_;
-    std::unique_ptr<TinyCLexer> lexer_;
-    std::unique_ptr<antlr4::CommonTokenStream> tokens_;
-    std::unique_ptr<TinyCParser> parser_;
+    std::shared_ptr<ParsedUnit> parse(std::unique_ptr<llvm::MemoryBuffer> buffer) const;
 
-    std::unique_ptr<ErrorListener> error_listener_;
+    std::string file_name_;
+    bool fast_lexer_;
 };
 
 #endif
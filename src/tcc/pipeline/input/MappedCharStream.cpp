@@ -0,0 +1,75 @@
+#include "MappedCharStream.h"
+
+MappedCharStream::MappedCharStream(std::unique_ptr<llvm::MemoryBuffer> buffer)
+    : buffer_(std::move(buffer))
+    , data_(buffer_->getBuffer())
+{
+}
+
+void MappedCharStream::consume()
+{
+    if (position_ >= data_.size()) {
+        throw antlr4::IllegalStateException("cannot consume EOF");
+    }
+    position_++;
+}
+
+size_t MappedCharStream::LA(ssize_t i)
+{
+    if (i == 0) {
+        return 0;
+    }
+    auto position = (ssize_t)position_ + (i < 0 ? i : i - 1);
+    if (position < 0 || position >= (ssize_t)data_.size()) {
+        return antlr4::IntStream::EOF;
+    }
+    return (unsigned char)data_[position];
+}
+
+ssize_t MappedCharStream::mark()
+{
+    return -1;
+}
+
+void MappedCharStream::release(ssize_t marker)
+{
+}
+
+size_t MappedCharStream::index()
+{
+    return position_;
+}
+
+void MappedCharStream::seek(size_t index)
+{
+    position_ = std::min(index, data_.size());
+}
+
+size_t MappedCharStream::size()
+{
+    return data_.size();
+}
+
+std::string MappedCharStream::getSourceName() const
+{
+    auto name = buffer_->getBufferIdentifier();
+    return name.empty() ? antlr4::IntStream::UNKNOWN_SOURCE_NAME : name.str();
+}
+
+std::string MappedCharStream::getText(const antlr4::misc::Interval& interval)
+{
+    if (interval.a < 0 || interval.b < interval.a || (size_t)interval.a >= data_.size()) {
+        return {};
+    }
+    return data_.slice(interval.a, interval.b + 1).str();
+}
+
+std::string MappedCharStream::toString() const
+{
+    return data_.str();
+}
+
+llvm::StringRef MappedCharStream::getBuffer() const
+{
+    return data_;
+}
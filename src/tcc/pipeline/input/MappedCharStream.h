@@ -0,0 +1,32 @@
+#ifndef TINYC_MAPPEDCHARSTREAM_H
+#define TINYC_MAPPEDCHARSTREAM_H
+
+#include "antlr4-runtime.h"
+
+// Feeds the lexer directly from a (possibly memory mapped) buffer, one symbol per byte.
+// TinyC sources are ASCII, any other byte is reported by the lexer as a token recognition error.
+class MappedCharStream : public antlr4::CharStream {
+public:
+    explicit MappedCharStream(std::unique_ptr<llvm::MemoryBuffer> buffer);
+
+    void consume() override;
+    size_t LA(ssize_t i) override;
+    ssize_t mark() override;
+    void release(ssize_t marker) override;
+    size_t index() override;
+    void seek(size_t index) override;
+    size_t size() override;
+    std::string getSourceName() const override;
+
+    std::string getText(const antlr4::misc::Interval& interval) override;
+    std::string toString() const override;
+
+    llvm::StringRef getBuffer() const;
+
+private:
+    std::unique_ptr<llvm::MemoryBuffer> buffer_;
+    llvm::StringRef data_;
+    size_t position_ = 0;
+};
+
+#endif
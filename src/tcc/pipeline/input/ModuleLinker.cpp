@@ -0,0 +1,56 @@
+#include "ModuleLinker.h"
+
+ModuleLinker::ModuleLinker(std::string moduleName, std::vector<llvm::SmallVector<char, 0>> bitcodes, bool internalize)
+    : module_name_(std::move(moduleName))
+    , bitcodes_(std::move(bitcodes))
+    , internalize_(internalize)
+{
+}
+
+ModuleLinker::ModuleLinker(std::string moduleName, std::vector<llvm::SmallVector<char, 0>> bitcodes, bool internalize, llvm::LLVMContext& context)
+    : module_name_(std::move(moduleName))
+    , bitcodes_(std::move(bitcodes))
+    , internalize_(internalize)
+    , context_(&context)
+{
+}
+
+std::any ModuleLinker::produce()
+{
+    if (!context_) {
+        own_context_ = std::make_unique<llvm::LLVMContext>();
+        context_ = own_context_.get();
+    }
+    auto linked = std::make_unique<llvm::Module>(module_name_, *context_);
+    llvm::Linker linker{*linked};
+
+    for (const auto& bitcode : bitcodes_) {
+        llvm::MemoryBufferRef buffer{llvm::StringRef{bitcode.data(), bitcode.size()}, module_name_};
+        auto module = llvm::parseBitcodeFile(buffer, *context_);
+        if (!module) {
+            TC_LOG_CRITICAL("can not read back emitted bitcode -- {}", llvm::toString(module.takeError()));
+            return {};
+        }
+        auto name = (*module)->getModuleIdentifier();
+        if (linker.linkInModule(std::move(*module))) {
+            TC_LOG_ERROR("can not link {} into {}", name, module_name_);
+            return {};
+        }
+    }
+    bitcodes_.clear();
+
+    if (internalize_) {
+        for (auto& function : *linked) {
+            if (!function.isDeclaration() && function.getName() != "main") {
+                function.setLinkage(llvm::GlobalValue::InternalLinkage);
+            }
+        }
+    }
+
+    return linked.release();
+}
+
+std::string_view ModuleLinker::getName() const
+{
+    return "link";
+}
@@ -0,0 +1,23 @@
+#ifndef TINYC_MODULELINKER_H
+#define TINYC_MODULELINKER_H
+
+#include "pipeline/PipelineStage.h"
+
+class ModuleLinker : public PipeInputBase {
+public:
+    ModuleLinker(std::string moduleName, std::vector<llvm::SmallVector<char, 0>> bitcodes, bool internalize);
+    ModuleLinker(std::string moduleName, std::vector<llvm::SmallVector<char, 0>> bitcodes, bool internalize, llvm::LLVMContext& context);
+
+    std::any produce() override;
+    std::string_view getName() const override;
+
+private:
+    std::string module_name_;
+    std::vector<llvm::SmallVector<char, 0>> bitcodes_;
+    bool internalize_;
+
+    std::unique_ptr<llvm::LLVMContext> own_context_;
+    llvm::LLVMContext* context_ = nullptr;
+};
+
+#endif
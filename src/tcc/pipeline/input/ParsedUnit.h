@@ -0,0 +1,16 @@
+#ifndef TINYC_PARSEDUNIT_H
+#define TINYC_PARSEDUNIT_H
+
+#include "MappedCharStream.h"
+#include "TinyCParser.h"
+
+// Everything the parse tree depends on, released as a whole once the ASG is built.
+struct ParsedUnit {
+    std::unique_ptr<MappedCharStream> input;
+    std::unique_ptr<antlr4::TokenSource> lexer;
+    std::unique_ptr<antlr4::CommonTokenStream> tokens;
+    std::unique_ptr<TinyCParser> parser;
+    TinyCParser::TranslationUnitContext* tree = nullptr;
+};
+
+#endif
@@ -0,0 +1,112 @@
+#include "SourceParser.h"
+
+#include "asg/AsgArena.h"
+#include "lexer/FastLexer.h"
+#include "parser/Parser.h"
+#include "utils/Parallel.h"
+
+// fewer tokens are parsed faster than a thread is started
+static constexpr size_t min_chunk_tokens = 8192;
+
+// top level entities end with a ';' at brace depth 0 or with the '}' of a function body,
+// returns ranges of whole entities with about the same number of tokens each
+static std::vector<llvm::ArrayRef<Token>> splitEntities(llvm::ArrayRef<Token> tokens, size_t chunks)
+{
+    std::vector<size_t> ends;
+    int depth = 0;
+    for (size_t i = 0; i < tokens.size(); i++) {
+        switch (tokens[i].kind) {
+        case Token::Kind::LBrace:
+            depth++;
+            break;
+        case Token::Kind::RBrace:
+            if (--depth == 0 && tokens[i + 1].kind != Token::Kind::Semicolon) {
+                ends.push_back(i + 1);
+            }
+            break;
+        case Token::Kind::Semicolon:
+            if (depth == 0) {
+                ends.push_back(i + 1);
+            }
+            break;
+        default:
+            break;
+        }
+        if (depth < 0) {
+            return {tokens};
+        }
+    }
+    if (depth != 0) {
+        return {tokens};
+    }
+
+    std::vector<llvm::ArrayRef<Token>> ranges;
+    size_t begin = 0;
+    size_t target = tokens.size() / chunks + 1;
+    // the last range always keeps the last entity and the Eof token
+    for (size_t i = 0; i + 1 < ends.size(); i++) {
+        if (ends[i] - begin >= target) {
+            ranges.push_back(tokens.slice(begin, ends[i] - begin));
+            begin = ends[i];
+        }
+    }
+    ranges.push_back(tokens.slice(begin));
+    return ranges;
+}
+
+SourceParser::SourceParser(std::string fileName, size_t jobs)
+    : file_name_(std::move(fileName))
+    , jobs_(jobs)
+{
+}
+
+std::any SourceParser::produce()
+{
+    auto file = llvm::MemoryBuffer::getFile(file_name_, false, false);
+    if (!file) {
+        TC_LOG_CRITICAL("cant open file {} -- {}", file_name_, file.getError().message());
+        return {};
+    }
+    auto source = (*file)->getBuffer();
+
+    FastLexer lexer{source};
+    auto tokens = lexer.tokenize();
+    if (lexer.hasErrors()) {
+        return {};
+    }
+
+    auto chunks = std::min(jobs_, tokens.size() / min_chunk_tokens);
+    if (chunks <= 1) {
+        auto* root = Parser{tokens, source}.parse();
+        if (!root) {
+            return {};
+        }
+        return root;
+    }
+
+    auto ranges = splitEntities(tokens, chunks);
+    // the lists of the ranges are destroyed once their entities moved to the root, on error with everything in them
+    std::vector<std::unique_ptr<AsgNode>> lists(ranges.size());
+    auto* arena = AsgArena::current();
+    parallelFor(ranges.size(), jobs_, [&](size_t i) {
+        AsgArena::Scope arenaScope{arena->createWorkerArena()};
+        lists[i].reset(Parser{ranges[i], source}.parse());
+    });
+
+    if (std::find(lists.begin(), lists.end(), nullptr) != lists.end()) {
+        return {};
+    }
+
+    auto root = std::make_unique<AsgStatementList>();
+    for (auto& list : lists) {
+        for (auto& entity : list->as<AsgStatementList>()->statements) {
+            root->statements.push_back(std::move(entity));
+        }
+    }
+    return (AsgNode*)root.release();
+}
+
+std::string_view SourceParser::getName() const
+{
+    return "parse";
+}
@@ -0,0 +1,18 @@
+#ifndef TINYC_SOURCEPARSER_H
+#define TINYC_SOURCEPARSER_H
+
+#include "pipeline/PipelineStage.h"
+
+class SourceParser : public PipeInputBase {
+public:
+    SourceParser(std::string fileName, size_t jobs);
+
+    std::any produce() override;
+    std::string_view getName() const override;
+
+private:
+    std::string file_name_;
+    size_t jobs_;
+};
+
+#endif
@@ -0,0 +1,25 @@
+#include "BitcodeBuffer.h"
+
+BitcodeBuffer::BitcodeBuffer(llvm::SmallVectorImpl<char>& bitcode)
+    : bitcode_(bitcode)
+{
+}
+
+bool BitcodeBuffer::consume(std::any data)
+{
+    if (data.type() != typeid(llvm::Module*)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to BitcodeBuffer -- expected llvm::Module*");
+        return false;
+    }
+    std::unique_ptr<llvm::Module> module{std::any_cast<llvm::Module*>(data)};
+
+    bitcode_.clear();
+    llvm::raw_svector_ostream ostream{bitcode_};
+    llvm::WriteBitcodeToFile(*module, ostream);
+    return true;
+}
+
+std::string_view BitcodeBuffer::getName() const
+{
+    return "buffer bitcode";
+}
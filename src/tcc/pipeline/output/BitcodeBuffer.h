@@ -0,0 +1,17 @@
+#ifndef TINYC_BITCODEBUFFER_H
+#define TINYC_BITCODEBUFFER_H
+
+#include "pipeline/PipelineStage.h"
+
+class BitcodeBuffer : public PipeOutputBase {
+public:
+    explicit BitcodeBuffer(llvm::SmallVectorImpl<char>& bitcode);
+
+    bool consume(std::any data) override;
+    std::string_view getName() const override;
+
+private:
+    llvm::SmallVectorImpl<char>& bitcode_;
+};
+
+#endif
@@ -0,0 +1,40 @@
+#include "BitcodeWriter.h"
+
+BitcodeWriter::BitcodeWriter(std::string fileName)
+    : file_name_(std::move(fileName))
+{
+}
+
+bool BitcodeWriter::consume(std::any data)
+{
+    if (data.type() != typeid(llvm::Module*)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to BitcodeWriter -- expected llvm::Module*");
+        return false;
+    }
+    std::unique_ptr<llvm::Module> module{std::any_cast<llvm::Module*>(data)};
+
+    llvm::SmallVector<char, 0> bitcode;
+    {
+        llvm::raw_svector_ostream ostream{bitcode};
+        llvm::WriteBitcodeToFile(*module, ostream);
+    }
+
+    auto buffer = llvm::FileOutputBuffer::create(file_name_, bitcode.size());
+    if (!buffer) {
+        TC_LOG_ERROR("can not open file {} for write -- {}", file_name_, llvm::toString(buffer.takeError()));
+        return false;
+    }
+
+    std::copy(bitcode.begin(), bitcode.end(), (*buffer)->getBufferStart());
+
+    if (auto err = (*buffer)->commit()) {
+        TC_LOG_ERROR("can not write file {} -- {}", file_name_, llvm::toString(std::move(err)));
+        return false;
+    }
+    return true;
+}
+
+std::string_view BitcodeWriter::getName() const
+{
+    return "write bitcode";
+}
@@ -0,0 +1,17 @@
+#ifndef TINYC_BITCODEWRITER_H
+#define TINYC_BITCODEWRITER_H
+
+#include "pipeline/PipelineStage.h"
+
+class BitcodeWriter : public PipeOutputBase {
+public:
+    explicit BitcodeWriter(std::string fileName);
+
+    bool consume(std::any data) override;
+    std::string_view getName() const override;
+
+private:
+    std::string file_name_;
+};
+
+#endif
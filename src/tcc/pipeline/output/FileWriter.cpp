@@ -28,3 +28,8 @@ bool FileWriter::consume(std::any data)
     delete module;
     return true;
 }
+
+std::string_view FileWriter::getName() const
+{
+    return "write";
+}
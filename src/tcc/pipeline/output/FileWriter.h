@@ -8,6 +8,7 @@ public:
     explicit FileWriter(std::string fileName);
 
     bool consume(std::any data) override;
+    std::string_view getName() const override;
 
 private:
     std::string file_name_;
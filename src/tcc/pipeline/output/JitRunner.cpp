@@ -0,0 +1,72 @@
+#include "JitRunner.h"
+
+JitRunner::JitRunner(bool reportTiming)
+    : context_(std::make_unique<llvm::LLVMContext>())
+    , report_timing_(reportTiming)
+{
+}
+
+bool JitRunner::consume(std::any data)
+{
+    if (data.type() != typeid(llvm::Module*)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to JitRunner -- expected llvm::Module*");
+        return false;
+    }
+    std::unique_ptr<llvm::Module> module{std::any_cast<llvm::Module*>(data)};
+
+    if (&module->getContext() != context_.getContext()) {
+        TC_LOG_CRITICAL("module passed to JitRunner was emitted in a foreign LLVMContext");
+        return false;
+    }
+
+    const auto compileStart = std::chrono::steady_clock::now();
+
+    auto jit = llvm::orc::LLJITBuilder{}.create();
+    if (!jit) {
+        TC_LOG_ERROR("can not create JIT -- {}", llvm::toString(jit.takeError()));
+        return false;
+    }
+
+    if (auto err = (*jit)->addIRModule(llvm::orc::ThreadSafeModule{std::move(module), context_})) {
+        TC_LOG_ERROR("can not add module to JIT -- {}", llvm::toString(std::move(err)));
+        return false;
+    }
+
+    auto mainSymbol = (*jit)->lookup("main");
+    if (!mainSymbol) {
+        TC_LOG_ERROR("can not find main -- {}", llvm::toString(mainSymbol.takeError()));
+        return false;
+    }
+    auto* mainFunction = llvm::jitTargetAddressToFunction<int (*)()>(mainSymbol->getAddress());
+
+    const auto runStart = std::chrono::steady_clock::now();
+
+    exit_code_ = mainFunction();
+
+    const auto runEnd = std::chrono::steady_clock::now();
+
+    if (report_timing_) {
+        using Ms = std::chrono::duration<double, std::milli>;
+        TC_LOG_INFO(
+            "jit compile {:.3f} ms, run {:.3f} ms",
+            Ms{runStart - compileStart}.count(),
+            Ms{runEnd - runStart}.count());
+    }
+
+    return true;
+}
+
+std::string_view JitRunner::getName() const
+{
+    return "jit";
+}
+
+llvm::LLVMContext& JitRunner::getContext()
+{
+    return *context_.getContext();
+}
+
+int JitRunner::getExitCode() const
+{
+    return exit_code_;
+}
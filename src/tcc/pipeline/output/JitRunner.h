@@ -0,0 +1,22 @@
+#ifndef TINYC_JITRUNNER_H
+#define TINYC_JITRUNNER_H
+
+#include "pipeline/PipelineStage.h"
+
+class JitRunner : public PipeOutputBase {
+public:
+    explicit JitRunner(bool reportTiming);
+
+    bool consume(std::any data) override;
+    std::string_view getName() const override;
+
+    llvm::LLVMContext& getContext();
+    int getExitCode() const;
+
+private:
+    llvm::orc::ThreadSafeContext context_;
+    bool report_timing_;
+    int exit_code_ = EXIT_FAILURE;
+};
+
+#endif
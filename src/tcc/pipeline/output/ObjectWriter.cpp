@@ -0,0 +1,97 @@
+#include "ObjectWriter.h"
+
+ObjectWriter::ObjectWriter(std::string fileName, Kind kind, llvm::TargetMachine& targetMachine)
+    : file_name_(std::move(fileName))
+    , kind_(kind)
+    , target_machine_(targetMachine)
+{
+}
+
+bool ObjectWriter::consume(std::any data)
+{
+    if (data.type() != typeid(llvm::Module*)) {
+        TC_LOG_CRITICAL("Unexpected data type passed to ObjectWriter -- expected llvm::Module*");
+        return false;
+    }
+    std::unique_ptr<llvm::Module> module{std::any_cast<llvm::Module*>(data)};
+
+    if (kind_ == Kind::Assembly) {
+        return emit(*module, file_name_, llvm::CGFT_AssemblyFile);
+    }
+    if (kind_ == Kind::Object) {
+        return emit(*module, file_name_, llvm::CGFT_ObjectFile);
+    }
+
+    llvm::SmallString<128> objectName;
+    if (auto ec = llvm::sys::fs::createTemporaryFile("tcc", "o", objectName)) {
+        TC_LOG_ERROR("can not create temporary object file -- {}", ec.message());
+        return false;
+    }
+    llvm::FileRemover objectRemover{objectName};
+
+    if (!emit(*module, std::string{objectName}, llvm::CGFT_ObjectFile)) {
+        return false;
+    }
+    return link(std::string{objectName});
+}
+
+std::string_view ObjectWriter::getName() const
+{
+    return "codegen";
+}
+
+bool ObjectWriter::emit(llvm::Module& module, const std::string& fileName, llvm::CodeGenFileType fileType)
+{
+    if (module.getTargetTriple() != target_machine_.getTargetTriple().str()) {
+        TC_LOG_CRITICAL("module passed to ObjectWriter was emitted for a different target {}", module.getTargetTriple());
+        return false;
+    }
+
+    std::error_code ec;
+    llvm::raw_fd_ostream ostream{
+        fileName,
+        ec,
+        fileType == llvm::CGFT_AssemblyFile ? llvm::sys::fs::OF_Text : llvm::sys::fs::OF_None};
+
+    if (ec) {
+        TC_LOG_ERROR("can not open file {} for write -- {}", fileName, ec.message());
+        return false;
+    }
+
+    {
+        llvm::legacy::PassManager passManager;
+        if (target_machine_.addPassesToEmitFile(passManager, ostream, nullptr, fileType)) {
+            TC_LOG_ERROR("target {} can not emit file of this type", module.getTargetTriple());
+            return false;
+        }
+        passManager.run(module);
+    }
+
+    ostream.close();
+    return true;
+}
+
+bool ObjectWriter::link(const std::string& objectName)
+{
+    llvm::ErrorOr<std::string> linker = std::make_error_code(std::errc::no_such_file_or_directory);
+    for (const auto* name : {"clang", "cc", "gcc"}) {
+        linker = llvm::sys::findProgramByName(name);
+        if (linker) {
+            break;
+        }
+    }
+    if (!linker) {
+        TC_LOG_ERROR("can not find linker driver (clang, cc or gcc) in PATH");
+        return false;
+    }
+
+    std::array<llvm::StringRef, 4> args{*linker, objectName, "-o", file_name_};
+
+    std::string error;
+    const auto rc = llvm::sys::ExecuteAndWait(*linker, args, llvm::None, {}, 0, 0, &error);
+    if (rc != 0) {
+        TC_LOG_ERROR("linking {} failed{}", file_name_, error.empty() ? "" : " -- " + error);
+        return false;
+    }
+    return true;
+}
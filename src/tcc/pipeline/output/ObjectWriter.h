@@ -0,0 +1,28 @@
+#ifndef TINYC_OBJECTWRITER_H
+#define TINYC_OBJECTWRITER_H
+
+#include "pipeline/PipelineStage.h"
+
+class ObjectWriter : public PipeOutputBase {
+public:
+    enum class Kind {
+        Assembly,
+        Object,
+        Executable
+    };
+
+    ObjectWriter(std::string fileName, Kind kind, llvm::TargetMachine& targetMachine);
+
+    bool consume(std::any data) override;
+    std::string_view getName() const override;
+
+private:
+    bool emit(llvm::Module& module, const std::string& fileName, llvm::CodeGenFileType fileType);
+    bool link(const std::string& objectName);
+
+    std::string file_name_;
+    Kind kind_;
+    llvm::TargetMachine& target_machine_;
+};
+
+#endif
@@ -11,3 +11,8 @@ bool TerminalWriter::consume(std::any data)
     delete module;
     return true;
 }
+
+std::string_view TerminalWriter::getName() const
+{
+    return "print";
+}
@@ -6,6 +6,7 @@
 class TerminalWriter : public PipeOutputBase {
 public:
     bool consume(std::any data) override;
+    std::string_view getName() const override;
 };
 
 #endif
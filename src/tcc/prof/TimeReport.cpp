@@ -0,0 +1,65 @@
+#include "TimeReport.h"
+
+#include "os/OsStats.h"
+
+TimeReport::Scope::Scope(TimeReport& report, std::string_view stage)
+    : report_(report)
+    , stage_(stage)
+    , wall_start_(std::chrono::steady_clock::now())
+    , cpu_start_(osThreadCpuTimeMs())
+    , peak_rss_start_(osPeakRssKb())
+{
+}
+
+TimeReport::Scope::~Scope()
+{
+    const std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - wall_start_;
+    report_.add(stage_, wall.count(), osThreadCpuTimeMs() - cpu_start_, osPeakRssKb() - peak_rss_start_);
+}
+
+void TimeReport::add(std::string_view stage, double wallMs, double cpuMs, size_t peakRssDeltaKb)
+{
+    std::lock_guard lock{mutex_};
+    auto entry = std::find_if(entries_.begin(), entries_.end(), [&](const Entry& e) { return e.stage == stage; });
+    if (entry == entries_.end()) {
+        entry = entries_.insert(entries_.end(), Entry{std::string{stage}});
+    }
+    entry->count++;
+    entry->wallMs += wallMs;
+    entry->cpuMs += cpuMs;
+    entry->peakRssDeltaKb += peakRssDeltaKb;
+}
+
+void TimeReport::printTable(std::ostream& os) const
+{
+    std::lock_guard lock{mutex_};
+
+    Entry total{"total"};
+    os << fmt::format("{:<20} {:>6} {:>12} {:>12} {:>16}\n", "stage", "count", "wall ms", "cpu ms", "peak rss +KiB");
+    for (const auto& e : entries_) {
+        os << fmt::format("{:<20} {:>6} {:>12.3f} {:>12.3f} {:>16}\n", e.stage, e.count, e.wallMs, e.cpuMs, e.peakRssDeltaKb);
+        total.wallMs += e.wallMs;
+        total.cpuMs += e.cpuMs;
+        total.peakRssDeltaKb += e.peakRssDeltaKb;
+    }
+    os << fmt::format("{:<20} {:>6} {:>12.3f} {:>12.3f} {:>16}\n", total.stage, "", total.wallMs, total.cpuMs, total.peakRssDeltaKb);
+}
+
+void TimeReport::printJson(std::ostream& os) const
+{
+    std::lock_guard lock{mutex_};
+
+    os << "{\"stages\":[";
+    for (size_t i = 0; i < entries_.size(); i++) {
+        const auto& e = entries_[i];
+        os << fmt::format(
+            "{}{{\"name\":\"{}\",\"count\":{},\"wall_ms\":{:.3f},\"cpu_ms\":{:.3f},\"peak_rss_delta_kb\":{}}}",
+            i == 0 ? "" : ",",
+            e.stage,
+            e.count,
+            e.wallMs,
+            e.cpuMs,
+            e.peakRssDeltaKb);
+    }
+    os << "]}\n";
+}
@@ -0,0 +1,40 @@
+#ifndef TINYC_TIMEREPORT_H
+#define TINYC_TIMEREPORT_H
+
+class TimeReport {
+public:
+    class Scope {
+    public:
+        Scope(TimeReport& report, std::string_view stage);
+        ~Scope();
+
+        Scope(const Scope&) = delete;
+        Scope& operator=(const Scope&) = delete;
+
+    private:
+        TimeReport& report_;
+        std::string_view stage_;
+        std::chrono::steady_clock::time_point wall_start_;
+        double cpu_start_;
+        size_t peak_rss_start_;
+    };
+
+    void add(std::string_view stage, double wallMs, double cpuMs, size_t peakRssDeltaKb);
+
+    void printTable(std::ostream& os) const;
+    void printJson(std::ostream& os) const;
+
+private:
+    struct Entry {
+        std::string stage;
+        size_t count = 0;
+        double wallMs = 0;
+        double cpuMs = 0;
+        size_t peakRssDeltaKb = 0;
+    };
+
+    mutable std::mutex mutex_;
+    std::vector<Entry> entries_;
+};
+
+#endif
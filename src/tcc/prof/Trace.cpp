@@ -0,0 +1,168 @@
+#include "Trace.h"
+
+namespace {
+
+struct TraceEvent {
+    char phase;
+    std::string category;
+    std::string name;
+    std::string detail;
+    uint64_t timestampUs;
+    uint32_t threadId;
+};
+
+struct TraceState {
+    std::atomic<bool> enabled = false;
+    std::chrono::steady_clock::time_point start = std::chrono::steady_clock::now();
+    std::atomic<uint32_t> nextThreadId = 1;
+    std::mutex mutex;
+    std::vector<TraceEvent> events;
+};
+
+TraceState& getState()
+{
+    static TraceState state;
+    return state;
+}
+
+uint32_t getThreadId()
+{
+    thread_local uint32_t threadId = getState().nextThreadId++;
+    return threadId;
+}
+
+void record(char phase, std::string_view category, std::string_view name, std::string_view detail)
+{
+    auto& state = getState();
+    const auto timestamp = std::chrono::duration_cast<std::chrono::microseconds>(
+        std::chrono::steady_clock::now() - state.start);
+
+    TraceEvent event{
+        phase,
+        std::string{category},
+        std::string{name},
+        std::string{detail},
+        static_cast<uint64_t>(timestamp.count()),
+        getThreadId()};
+
+    std::lock_guard lock{state.mutex};
+    state.events.push_back(std::move(event));
+}
+
+void writeEscaped(llvm::raw_ostream& os, std::string_view str)
+{
+    os << '"';
+    for (char c : str) {
+        switch (c) {
+        case '"':
+            os << "\\\"";
+            break;
+        case '\\':
+            os << "\\\\";
+            break;
+        case '\n':
+            os << "\\n";
+            break;
+        case '\t':
+            os << "\\t";
+            break;
+        default:
+            if (static_cast<unsigned char>(c) < 0x20) {
+                os << fmt::format("\\u{:04x}", static_cast<int>(c));
+            } else {
+                os << c;
+            }
+        }
+    }
+    os << '"';
+}
+
+}// namespace
+
+void traceEnable()
+{
+    getState().enabled = true;
+}
+
+void traceReset()
+{
+    auto& state = getState();
+    std::lock_guard lock{state.mutex};
+    state.enabled = false;
+    state.start = std::chrono::steady_clock::now();
+    state.events.clear();
+    state.events.shrink_to_fit();
+}
+
+bool traceEnabled()
+{
+    return getState().enabled.load(std::memory_order_relaxed);
+}
+
+bool traceWrite(const std::string& fileName)
+{
+    std::error_code ec;
+    llvm::raw_fd_ostream ostream{fileName, ec};
+
+    if (ec) {
+        TC_LOG_ERROR("can not open file {} for write -- {}", fileName, ec.message());
+        return false;
+    }
+
+    auto& state = getState();
+    std::lock_guard lock{state.mutex};
+
+    ostream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+    for (size_t i = 0; i < state.events.size(); i++) {
+        const auto& event = state.events[i];
+        ostream << (i == 0 ? "\n" : ",\n");
+        ostream << "{\"ph\":\"" << event.phase << "\",\"pid\":1,\"tid\":" << event.threadId
+                << ",\"ts\":" << event.timestampUs;
+        if (event.phase == 'B') {
+            ostream << ",\"cat\":";
+            writeEscaped(ostream, event.category);
+            ostream << ",\"name\":";
+            writeEscaped(ostream, event.name);
+            if (!event.detail.empty()) {
+                ostream << ",\"args\":{\"detail\":";
+                writeEscaped(ostream, event.detail);
+                ostream << "}";
+            }
+        }
+        ostream << "}";
+    }
+    ostream << "\n]}\n";
+
+    ostream.close();
+    if (ostream.has_error()) {
+        TC_LOG_ERROR("can not write file {} -- {}", fileName, ostream.error().message());
+        ostream.clear_error();
+        return false;
+    }
+    return true;
+}
+
+void traceBegin(std::string_view category, std::string_view name, std::string_view detail)
+{
+    record('B', category, name, detail);
+}
+
+void traceEnd()
+{
+    record('E', {}, {}, {});
+}
+
+TraceScope::TraceScope(std::string_view category, std::string_view name, std::string_view detail)
+    : active_(traceEnabled())
+{
+    if (active_) {
+        traceBegin(category, name, detail);
+    }
+}
+
+TraceScope::~TraceScope()
+{
+    if (active_) {
+        traceEnd();
+    }
+}
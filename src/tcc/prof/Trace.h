@@ -0,0 +1,24 @@
+#ifndef TINYC_TRACE_H
+#define TINYC_TRACE_H
+
+void traceEnable();
+void traceReset();
+bool traceEnabled();
+bool traceWrite(const std::string& fileName);
+
+void traceBegin(std::string_view category, std::string_view name, std::string_view detail = {});
+void traceEnd();
+
+class TraceScope {
+public:
+    TraceScope(std::string_view category, std::string_view name, std::string_view detail = {});
+    ~TraceScope();
+
+    TraceScope(const TraceScope&) = delete;
+    TraceScope& operator=(const TraceScope&) = delete;
+
+private:
+    bool active_;
+};
+
+#endif
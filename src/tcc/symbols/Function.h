@@ -1,13 +1,16 @@
 #ifndef TINYC_FUNCTION_H
 #define TINYC_FUNCTION_H
 
+#include "Identifier.h"
 #include "Type.h"
 
 struct Function {
-    std::string name;
+    Identifier name;
     Type::Id returnType;
     Type::Id origRetType = Type::invalid();
     std::vector<Type::Id> parameters;
+    bool defined = false;
+    bool lowered = false;
 };
 
 using FunctionId = Function*;
@@ -1,16 +1,6 @@
 #include "FunctionLib.h"
 
-static FunctionLibrary* instance = nullptr;
-
-FunctionLibrary& FunctionLibrary::inst()
-{
-    if (!instance) {
-        instance = new FunctionLibrary;
-    }
-    return *instance;
-}
-
-FunctionId FunctionLibrary::get(const std::string& name)
+FunctionId FunctionLibrary::get(Identifier name)
 {
     if (named_functions_.find(name) != named_functions_.end()) {
         return &named_functions_.at(name);
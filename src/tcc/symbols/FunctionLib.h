@@ -5,15 +5,11 @@
 
 class FunctionLibrary {
 public:
-    static FunctionLibrary& inst();
-
-    FunctionId get(const std::string& name);
+    FunctionId get(Identifier name);
     FunctionId add(const Function& function);
 
 private:
-    FunctionLibrary() = default;
-
-    std::unordered_map<std::string, Function> named_functions_;
+    std::unordered_map<Identifier, Function> named_functions_;
 };
 
 #endif
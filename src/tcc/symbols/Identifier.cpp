@@ -0,0 +1,10 @@
+#include "Identifier.h"
+
+#include "asg/AsgArena.h"
+
+Identifier Identifier::get(llvm::StringRef name)
+{
+    auto* arena = AsgArena::current();
+    TC_ASSERT(arena);
+    return arena->intern(name);
+}
@@ -0,0 +1,68 @@
+#ifndef TINYC_IDENTIFIER_H
+#define TINYC_IDENTIFIER_H
+
+// name interned in the current AsgArena, equal names share a single copy so identifiers compare and hash by address
+class Identifier {
+public:
+    Identifier() = default;
+
+    static Identifier get(llvm::StringRef name);
+
+    llvm::StringRef str() const
+    {
+        return name_;
+    }
+
+    bool empty() const
+    {
+        return name_.empty();
+    }
+
+    bool operator==(const Identifier& other) const
+    {
+        return name_.data() == other.name_.data();
+    }
+
+    bool operator!=(const Identifier& other) const
+    {
+        return !(*this == other);
+    }
+
+private:
+    friend class AsgArena;
+
+    explicit Identifier(llvm::StringRef name)
+        : name_(name)
+    {
+    }
+
+    llvm::StringRef name_;
+};
+
+inline std::ostream& operator<<(std::ostream& stream, const Identifier& identifier)
+{
+    return stream << std::string_view{identifier.str()};
+}
+
+namespace std {
+
+template<>
+struct hash<Identifier> {
+    size_t operator()(const Identifier& identifier) const
+    {
+        return std::hash<const char*>{}(identifier.str().data());
+    }
+};
+
+}// namespace std
+
+template<>
+struct fmt::formatter<Identifier> : fmt::formatter<std::string_view> {
+    template<typename FormatContext>
+    auto format(const Identifier& identifier, FormatContext& ctx) const
+    {
+        return fmt::formatter<std::string_view>::format(identifier.str(), ctx);
+    }
+};
+
+#endif
@@ -1,8 +1,12 @@
 #include "SymbolResolver.h"
 
 #include "asg/AsgNode.h"
-#include "FunctionLib.h"
-#include "TypeLib.h"
+
+SymbolResolver::SymbolResolver(TypeLibrary& types, FunctionLibrary& functions)
+    : types_(types)
+    , functions_(functions)
+{
+}
 
 std::any SymbolResolver::modify(std::any data)
 {
@@ -11,269 +15,261 @@ std::any SymbolResolver::modify(std::any data)
         return {};
     }
     auto* root = std::any_cast<AsgNode*>(data);
-    root->accept(this);
+    visit(root);
     if (ok_) {
         return root;
     }
     return {};
 }
 
-std::any SymbolResolver::visitStatementList(struct AsgStatementList* node)
+std::string_view SymbolResolver::getName() const
+{
+    return "symbol resolution";
+}
+
+void SymbolResolver::visitStatementList(AsgStatementList* node)
 {
     node->list = top_scope_;
     top_scope_ = node;
 
     node->function = current_function_;
 
+    enterScope();
     for (auto& n : node->statements) {
-        n->accept(this);
+        visit(n);
         n->parent = node;
     }
+    leaveScope();
 
     top_scope_ = node->list;
-
-    return {};
 }
 
-std::any SymbolResolver::visitStructDefinition(struct AsgStructDefinition* node)
+void SymbolResolver::visitStructDefinition(AsgStructDefinition* node)
 {
-    std::vector<std::pair<Type::Id, std::string>> fields;
+    std::vector<std::pair<Type::Id, Identifier>> fields;
     for (auto& field : node->fields) {
-        auto type = TypeLibrary::inst().get(field.type);
+        auto type = types_.get(field.type);
         if (!type) {
-            TC_LOG_ERROR("at line {} -- undefined type {}", field.refLine, field.type);
+            TC_LOG_ERROR("at line {} -- undefined type {}", field.refLine, field.type.toString());
             ok_ = false;
             continue;
         }
         fields.emplace_back(type, field.name);
     }
-    if (!TypeLibrary::inst().add(node->name, std::make_shared<StructType>(node->name, fields))) {
+    if (!types_.add(node->name.str(), std::make_unique<StructType>(node->name.str().str(), fields))) {
         TC_LOG_ERROR("at line {} -- type {} already declared", node->refLine, node->name);
         ok_ = false;
     }
-    return {};
 }
 
-std::any SymbolResolver::visitFunctionDefinition(struct AsgFunctionDefinition* node)
+void SymbolResolver::visitFunctionDefinition(AsgFunctionDefinition* node)
 {
     Function function;
     function.name = node->name;
 
-    auto retType = TypeLibrary::inst().get(node->returnType);
+    auto retType = types_.get(node->returnType);
 
     if (!retType) {
-        TC_LOG_ERROR("at line {} -- undefined function return type {}", node->refLine, node->returnType);
+        TC_LOG_ERROR("at line {} -- undefined function return type {}", node->refLine, node->returnType.toString());
         ok_ = false;
     }
 
     function.returnType = retType;
 
-    auto* topBlock = (AsgStatementList*)node->body.get();
+    current_function_ = node;
+    enterScope();
 
     for (auto& parameter : node->parameters) {
-        auto type = TypeLibrary::inst().get(parameter.type);
+        auto type = types_.get(parameter.type);
         if (!type) {
-            TC_LOG_ERROR("at line {} -- undefined type {} of param {}", node->refLine, parameter.type, parameter.name);
+            TC_LOG_ERROR("at line {} -- undefined type {} of param {}", node->refLine, parameter.type.toString(), parameter.name);
             ok_ = false;
         }
         function.parameters.push_back(type);
 
-        topBlock->localVariables.insert({parameter.name, type});
+        parameter.slot = declareVar(parameter.name, type);
     }
 
-    node->type = FunctionLibrary::inst().add(function);
+    node->type = functions_.get(node->name);
 
     if (!node->type) {
-        TC_LOG_ERROR("at line {} -- function {} already declared", node->refLine, node->name);
+        node->type = functions_.add(function);
+    } else if (node->type->defined && node->body) {
+        TC_LOG_ERROR("at line {} -- function {} already defined", node->refLine, node->name);
+        ok_ = false;
+    } else if (!isSameSignature(*node->type, function)) {
+        TC_LOG_ERROR("at line {} -- conflicting declaration of function {}", node->refLine, node->name);
         ok_ = false;
     }
 
-    current_function_ = node;
-
-    node->body->accept(this);
-    node->body->parent = node;
+    if (node->body) {
+        node->type->defined = true;
+        visit(node->body);
+        node->body->parent = node;
+    }
 
+    leaveScope();
     current_function_ = nullptr;
-
-    return {};
 }
 
-std::any SymbolResolver::visitVariableDefinition(struct AsgVariableDefinition* node)
+void SymbolResolver::visitVariableDefinition(AsgVariableDefinition* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    if (findVarType(node->name)) {
+    if (findVarSlot(node->name)) {
         TC_LOG_ERROR("at line {} -- variable {} already defined", node->refLine, node->name);
         ok_ = false;
     }
 
-    auto type = TypeLibrary::inst().get(node->type);
+    auto type = types_.get(node->type);
     if (!type) {
-        TC_LOG_ERROR("at line {} -- undefined variable type {}", node->refLine, node->type);
+        TC_LOG_ERROR("at line {} -- undefined variable type {}", node->refLine, node->type.toString());
         ok_ = false;
     }
 
-    top_scope_->localVariables.insert({node->name, type});
+    node->slot = declareVar(node->name, type);
 
     if (node->value) {
-        node->value->accept(this);
+        visit(node->value);
         node->value->parent = node;
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitReturn(struct AsgReturn* node)
+void SymbolResolver::visitReturn(AsgReturn* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->value->accept(this);
+    visit(node->value);
     node->value->parent = node;
-
-    return {};
 }
 
-std::any SymbolResolver::visitAssignment(struct AsgAssignment* node)
+void SymbolResolver::visitAssignment(AsgAssignment* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->assignable->accept(this);
-    node->value->accept(this);
+    visit(node->assignable);
+    visit(node->value);
     node->value->parent = node;
-
-    return {};
 }
 
-std::any SymbolResolver::visitConditional(struct AsgConditional* node)
+void SymbolResolver::visitConditional(AsgConditional* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->condition->accept(this);
+    visit(node->condition);
     node->condition->parent = node;
 
-    node->thenNode->accept(this);
+    visit(node->thenNode);
     node->thenNode->parent = node;
 
     if (node->elseNode) {
-        node->elseNode->accept(this);
+        visit(node->elseNode);
         node->elseNode->parent = node;
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitLoop(struct AsgLoop* node)
+void SymbolResolver::visitLoop(AsgLoop* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->condition->accept(this);
-    node->body->accept(this);
-    return {};
+    visit(node->condition);
+    visit(node->body);
 }
 
-std::any SymbolResolver::visitComp(struct AsgComp* node)
+void SymbolResolver::visitComp(AsgComp* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->rhs->accept(this);
+    visit(node->rhs);
     node->rhs->parent = node;
 
-    node->lhs->accept(this);
+    visit(node->lhs);
     node->lhs->parent = node;
-
-    return {};
 }
 
-std::any SymbolResolver::visitAddSub(struct AsgAddSub* node)
+void SymbolResolver::visitAddSub(AsgAddSub* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
     for (auto& subexpression : node->subexpressions) {
-        subexpression.expression->accept(this);
+        visit(subexpression.expression);
         subexpression.expression->parent = node;
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitMulDiv(struct AsgMulDiv* node)
+void SymbolResolver::visitMulDiv(AsgMulDiv* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
     for (auto& subexpression : node->subexpressions) {
-        subexpression.expression->accept(this);
+        visit(subexpression.expression);
         subexpression.expression->parent = node;
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitFieldAccess(struct AsgFieldAccess* node)
+void SymbolResolver::visitFieldAccess(AsgFieldAccess* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->accessed->accept(this);
-    return {};
+    visit(node->accessed);
 }
 
-std::any SymbolResolver::visitIndexing(struct AsgIndexing* node)
+void SymbolResolver::visitIndexing(AsgIndexing* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    node->indexed->accept(this);
+    visit(node->indexed);
 
     for (auto& index : node->indexes) {
-        index->accept(this);
+        visit(index);
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitOpDeref(struct AsgOpDeref* node)
+void SymbolResolver::visitOpDeref(AsgOpDeref* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    return node->expression->accept(this);
+    visit(node->expression);
 }
 
-std::any SymbolResolver::visitOpRef(struct AsgOpRef* node)
+void SymbolResolver::visitOpRef(AsgOpRef* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    return node->value->accept(this);
+    visit(node->value);
 }
 
-std::any SymbolResolver::visitVariable(struct AsgVariable* node)
+void SymbolResolver::visitVariable(AsgVariable* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    if (!findVarType(node->name)) {
+    if (auto slot = findVarSlot(node->name)) {
+        node->slot = *slot;
+    } else {
         TC_LOG_ERROR("at line {} -- undefined variable {}", node->refLine, node->name);
         ok_ = false;
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitCall(struct AsgCall* node)
+void SymbolResolver::visitCall(AsgCall* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
 
-    auto funId = FunctionLibrary::inst().get(node->functionName);
+    auto funId = functions_.get(node->functionName);
 
     if (!funId) {
         TC_LOG_ERROR("at line {} -- undefined function {} call", node->refLine, node->functionName);
@@ -283,29 +279,57 @@ std::any SymbolResolver::visitCall(struct AsgCall* node)
     node->callee = funId;
 
     for (auto& arg : node->arguments) {
-        arg->accept(this);
+        visit(arg);
         arg->parent = node;
     }
-
-    return {};
 }
 
-std::any SymbolResolver::visitIntLiteral(struct AsgIntLiteral* node)
+void SymbolResolver::visitIntLiteral(AsgIntLiteral* node)
 {
     node->function = current_function_;
     node->list = top_scope_;
-
-    return {};
 }
 
-Type::Id SymbolResolver::findVarType(const std::string& name) const
+bool SymbolResolver::isSameSignature(const Function& lhs, const Function& rhs)
 {
-    auto* currScope = top_scope_;
-    while (currScope) {
-        if (currScope->localVariables.find(name) != currScope->localVariables.end()) {
-            return currScope->localVariables.at(name);
+    if (!Type::isSame(lhs.returnType, rhs.returnType) || lhs.parameters.size() != rhs.parameters.size()) {
+        return false;
+    }
+    for (size_t i = 0; i < lhs.parameters.size(); i++) {
+        if (!Type::isSame(lhs.parameters[i], rhs.parameters[i])) {
+            return false;
         }
-        currScope = currScope->list;
     }
-    return nullptr;
+    return true;
+}
+
+void SymbolResolver::enterScope()
+{
+    scope_starts_.push_back(declared_vars_.size());
+}
+
+void SymbolResolver::leaveScope()
+{
+    while (declared_vars_.size() > scope_starts_.back()) {
+        var_slots_[declared_vars_.back()].pop_back();
+        declared_vars_.pop_back();
+    }
+    scope_starts_.pop_back();
+}
+
+size_t SymbolResolver::declareVar(Identifier name, Type::Id type)
+{
+    auto slot = current_function_->addSlot(type);
+    var_slots_[name].push_back(slot);
+    declared_vars_.push_back(name);
+    return slot;
+}
+
+std::optional<size_t> SymbolResolver::findVarSlot(Identifier name) const
+{
+    auto slots = var_slots_.find(name);
+    if (slots == var_slots_.end() || slots->second.empty()) {
+        return std::nullopt;
+    }
+    return slots->second.back();
 }
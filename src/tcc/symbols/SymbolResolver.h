@@ -1,42 +1,61 @@
 #ifndef TINYC_SYMBOLRESOLVER_H
 #define TINYC_SYMBOLRESOLVER_H
 
-#include "asg/AsgNode.h"
 #include "asg/AsgVisitor.h"
+#include "FunctionLib.h"
 #include "pipeline/PipelineStage.h"
 #include "Type.h"
+#include "TypeLib.h"
 
-class SymbolResolver : private AsgVisitorBase,
+class SymbolResolver : private AsgVisitor<SymbolResolver, void>,
                        public PipeModifierBase {
 public:
+    SymbolResolver(TypeLibrary& types, FunctionLibrary& functions);
+
     std::any modify(std::any data) override;
+    std::string_view getName() const override;
 
 private:
-    std::any visitStatementList(struct AsgStatementList* node) override;
-    std::any visitStructDefinition(struct AsgStructDefinition* node) override;
-    std::any visitFunctionDefinition(struct AsgFunctionDefinition* node) override;
-    std::any visitVariableDefinition(struct AsgVariableDefinition* node) override;
-    std::any visitReturn(struct AsgReturn* node) override;
-    std::any visitAssignment(struct AsgAssignment* node) override;
-    std::any visitConditional(struct AsgConditional* node) override;
-    std::any visitLoop(struct AsgLoop* node) override;
-
-    std::any visitComp(struct AsgComp* node) override;
-    std::any visitAddSub(struct AsgAddSub* node) override;
-    std::any visitMulDiv(struct AsgMulDiv* node) override;
-    std::any visitFieldAccess(struct AsgFieldAccess* node) override;
-    std::any visitIndexing(struct AsgIndexing* node) override;
-    std::any visitOpDeref(struct AsgOpDeref* node) override;
-    std::any visitOpRef(struct AsgOpRef* node) override;
-    std::any visitVariable(struct AsgVariable* node) override;
-    std::any visitCall(struct AsgCall* node) override;
-    std::any visitIntLiteral(struct AsgIntLiteral* node) override;
-
-    Type::Id findVarType(const std::string& name) const;
+    friend class AsgVisitor<SymbolResolver, void>;
+
+    void visitStatementList(AsgStatementList* node);
+    void visitStructDefinition(AsgStructDefinition* node);
+    void visitFunctionDefinition(AsgFunctionDefinition* node);
+    void visitVariableDefinition(AsgVariableDefinition* node);
+    void visitReturn(AsgReturn* node);
+    void visitAssignment(AsgAssignment* node);
+    void visitConditional(AsgConditional* node);
+    void visitLoop(AsgLoop* node);
+
+    void visitComp(AsgComp* node);
+    void visitAddSub(AsgAddSub* node);
+    void visitMulDiv(AsgMulDiv* node);
+    void visitFieldAccess(AsgFieldAccess* node);
+    void visitIndexing(AsgIndexing* node);
+    void visitOpDeref(AsgOpDeref* node);
+    void visitOpRef(AsgOpRef* node);
+    void visitVariable(AsgVariable* node);
+    void visitCall(AsgCall* node);
+    void visitIntLiteral(AsgIntLiteral* node);
+
+    static bool isSameSignature(const Function& lhs, const Function& rhs);
+
+    void enterScope();
+    void leaveScope();
+
+    size_t declareVar(Identifier name, Type::Id type);
+    std::optional<size_t> findVarSlot(Identifier name) const;
+
+    TypeLibrary& types_;
+    FunctionLibrary& functions_;
 
     AsgStatementList* top_scope_ = nullptr;
     AsgFunctionDefinition* current_function_ = nullptr;
 
+    std::unordered_map<Identifier, std::vector<size_t>> var_slots_;
+    std::vector<Identifier> declared_vars_;
+    std::vector<size_t> scope_starts_;
+
     bool ok_ = true;
 };
 
@@ -1,7 +1,12 @@
 #include "Type.h"
 
-bool Type::isSame(const Type::Id& lhs, const Type::Id& rhs)
+Type::~Type() = default;
+
+bool Type::isSame(Type::Id lhs, Type::Id rhs)
 {
+    if (lhs == rhs) {
+        return lhs != nullptr;
+    }
     if (!lhs || !rhs) {
         return false;
     }
@@ -10,7 +15,7 @@ bool Type::isSame(const Type::Id& lhs, const Type::Id& rhs)
     }
     switch (lhs->getCategory()) {
     case Category::Basic:
-        return lhs == rhs;
+        return false;
     case Category::Ptr:
         return isSame(lhs->as<PtrType>()->getDeref(), rhs->as<PtrType>()->getDeref());
     case Category::Array: {
@@ -19,10 +24,10 @@ bool Type::isSame(const Type::Id& lhs, const Type::Id& rhs)
         if (lhsA->getSize() == -1 || rhsA->getSize() == -1) {
             return isSame(lhsA->getIndexed(), rhsA->getIndexed());
         }
-        return isSame(lhsA->getIndexed(), rhsA->getIndexed()) && lhsA->getSize() == rhsA->getSize();
+        return lhsA->getSize() == rhsA->getSize() && isSame(lhsA->getIndexed(), rhsA->getIndexed());
     }
     case Category::Struct:
-        return lhs == rhs;
+        return false;
     default:
         TC_ASSERT_FAIL("unexpected category");
         return false;
@@ -31,21 +36,28 @@ bool Type::isSame(const Type::Id& lhs, const Type::Id& rhs)
 
 Type::Id Type::getRef()
 {
-    return std::make_shared<PtrType>(shared_from_this());
+    if (!ref_) {
+        ref_ = std::make_unique<PtrType>(this);
+    }
+    return ref_.get();
 }
 
 Type::Id Type::getArray(int size)
 {
-    return std::make_shared<ArrayType>(shared_from_this(), size);
+    auto& array = arrays_[size];
+    if (!array) {
+        array = std::make_unique<ArrayType>(this, size);
+    }
+    return array.get();
 }
 
-StructType::StructType(std::string name, std::vector<std::pair<Id, std::string>> fields)
+StructType::StructType(std::string name, std::vector<std::pair<Id, Identifier>> fields)
     : name_(std::move(name))
     , fields_(std::move(fields))
 {
 }
 
-int StructType::getFieldId(std::string_view name) const
+int StructType::getFieldId(Identifier name) const
 {
     auto elem = std::find_if(fields_.begin(), fields_.end(), [&](const auto& p) { return p.second == name; });
     if (elem == fields_.end()) {
@@ -54,7 +66,7 @@ int StructType::getFieldId(std::string_view name) const
     return (int)(elem - fields_.begin());
 }
 
-Type::Id StructType::getFieldType(std::string_view name) const
+Type::Id StructType::getFieldType(Identifier name) const
 {
     auto elem = std::find_if(fields_.begin(), fields_.end(), [&](const auto& p) { return p.second == name; });
     if (elem == fields_.end()) {
@@ -65,7 +77,7 @@ Type::Id StructType::getFieldType(std::string_view name) const
 
 Type::Id StructType::getNamed()
 {
-    return shared_from_this();
+    return this;
 }
 
 std::string StructType::toString()
@@ -91,7 +103,7 @@ llvm::Type* StructType::getLLVMParamType(llvm::LLVMContext& ctx, unsigned int ad
 }
 
 ArrayType::ArrayType(Type::Id underlying, int size)
-    : underlying_(std::move(underlying))
+    : underlying_(underlying)
     , size_(size)
 {
 }
@@ -133,7 +145,7 @@ llvm::Type* ArrayType::getLLVMParamType(llvm::LLVMContext& ctx, unsigned int add
 }
 
 PtrType::PtrType(Type::Id underlying)
-    : underlying_(std::move(underlying))
+    : underlying_(underlying)
 {
 }
 
@@ -165,7 +177,7 @@ BaseType::BaseType(std::string name, BaseType::TypeGetter typeGetter)
 
 Type::Id BaseType::getNamed()
 {
-    return shared_from_this();
+    return this;
 }
 
 std::string BaseType::toString()
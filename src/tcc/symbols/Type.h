@@ -1,6 +1,8 @@
 #ifndef TINYC_TCTYPE_H
 #define TINYC_TCTYPE_H
 
+#include "Identifier.h"
+
 #define DECL_TYPE_CATEGORY(c)                   \
     static Type::Category getCategoryStatic()   \
     {                                           \
@@ -11,8 +13,11 @@
         return c;                               \
     }
 
-struct Type : public std::enable_shared_from_this<Type> {
-    using Id = std::shared_ptr<Type>;
+class ArrayType;
+class PtrType;
+
+struct Type {
+    using Id = Type*;
 
     enum class Category {
         Basic,
@@ -26,7 +31,9 @@ struct Type : public std::enable_shared_from_this<Type> {
         return nullptr;
     };
 
-    static bool isSame(const Type::Id& lhs, const Type::Id& rhs);
+    virtual ~Type();
+
+    static bool isSame(Type::Id lhs, Type::Id rhs);
 
     template<typename T>
     T* as()
@@ -37,8 +44,8 @@ struct Type : public std::enable_shared_from_this<Type> {
         return nullptr;
     }
 
-    virtual Id getRef();
-    virtual Id getArray(int size);
+    Id getRef();
+    Id getArray(int size);
 
     virtual Category getCategory() const = 0;
     virtual Id getNamed() = 0;
@@ -50,16 +57,20 @@ struct Type : public std::enable_shared_from_this<Type> {
     {
         return getLLVMType(ctx, addrSpace);
     }
+
+private:
+    std::unique_ptr<PtrType> ref_;
+    std::map<int, std::unique_ptr<ArrayType>> arrays_;
 };
 
 class StructType : public Type {
 public:
     DECL_TYPE_CATEGORY(Category::Struct)
 
-    explicit StructType(std::string name, std::vector<std::pair<Id, std::string>> fields);
+    explicit StructType(std::string name, std::vector<std::pair<Id, Identifier>> fields);
 
-    int getFieldId(std::string_view name) const;
-    Id getFieldType(std::string_view name) const;
+    int getFieldId(Identifier name) const;
+    Id getFieldType(Identifier name) const;
 
     Id getNamed() override;
 
@@ -71,7 +82,7 @@ public:
 private:
     mutable llvm::Type* self_type_ = nullptr;
     std::string name_;
-    std::vector<std::pair<Id, std::string>> fields_;
+    std::vector<std::pair<Id, Identifier>> fields_;
 };
 
 class ArrayType : public Type {
@@ -138,8 +149,8 @@ struct LRValue {
         R
     };
 
-    explicit LRValue(Type::Id t, Side s = Side::R)
-        : type(std::move(t))
+    explicit LRValue(Type::Id t = Type::invalid(), Side s = Side::R)
+        : type(t)
         , side(s)
     {
     }
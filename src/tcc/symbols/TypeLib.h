@@ -2,18 +2,22 @@
 #define TINYC_TCTYPELIB_H
 
 #include "Type.h"
+#include "TypeRef.h"
 
 class TypeLibrary {
 public:
-    static TypeLibrary& inst();
+    TypeLibrary();
 
-    Type::Id get(const std::string& name) const;
-    bool add(const std::string& name, const Type::Id& tid);
+    Type::Id get(const TypeRef& ref) const;
+    bool add(llvm::StringRef name, std::unique_ptr<Type> type);
 
-private:
-    TypeLibrary();
+    Type::Id getInt() const;
+    Type::Id getVoid() const;
 
-    std::unordered_map<std::string, Type::Id> named_types_;
+private:
+    Type::Id int_ = nullptr;
+    Type::Id void_ = nullptr;
+    llvm::StringMap<std::unique_ptr<Type>> named_types_;
 };
 
 #endif
@@ -0,0 +1,21 @@
+#ifndef TINYC_TYPEREF_H
+#define TINYC_TYPEREF_H
+
+#include "Identifier.h"
+
+struct TypeRef {
+    Identifier name;
+    size_t ptrDepth = 0;
+    std::vector<int> dimensions;
+
+    std::string toString() const
+    {
+        auto str = name.str().str() + std::string(ptrDepth, '*');
+        for (auto dim : dimensions) {
+            str += dim == -1 ? "[]" : "[" + std::to_string(dim) + "]";
+        }
+        return str;
+    }
+};
+
+#endif
@@ -1,6 +1,6 @@
 #include "TypeResolver.h"
 
-#include "TypeLib.h"
+#include "prof/Trace.h"
 
 struct VisUpdater {
     VisUpdater(AsgNode* n, std::deque<AsgNode*>& ns)
@@ -23,14 +23,19 @@ struct VisUpdater {
         (n), (ns)                   \
     }
 
-static std::string getTmpRetName(const std::string& funName)
+static Identifier getTmpRetName(Identifier funName)
 {
-    return "." + funName + "_ret";
+    return Identifier::get(("." + funName.str() + "_ret").str());
 }
 
-static std::string getTmpParamName(const std::string& origName)
+static Identifier getTmpParamName(Identifier origName)
+{
+    return Identifier::get(("." + origName.str() + "_par").str());
+}
+
+TypeResolver::TypeResolver(TypeLibrary& types)
+    : types_(types)
 {
-    return "." + origName + "_par";
 }
 
 std::any TypeResolver::modify(std::any data)
@@ -40,14 +45,19 @@ std::any TypeResolver::modify(std::any data)
         return {};
     }
     auto* root = std::any_cast<AsgNode*>(data);
-    root->accept(this);
+    visit(root);
     if (ok_) {
         return root;
     }
     return {};
 }
 
-std::any TypeResolver::visitStatementList(struct AsgStatementList* node)
+std::string_view TypeResolver::getName() const
+{
+    return "type resolution";
+}
+
+LRValue TypeResolver::visitStatementList(AsgStatementList* node)
 {
     UPDATE_VIS(node, nodes_);
 
@@ -60,34 +70,40 @@ std::any TypeResolver::visitStatementList(struct AsgStatementList* node)
         [](const std::unique_ptr<AsgNode>& n) { return n.get(); });
 
     for (auto* statement : toVisit) {
-        statement->accept(this);
+        visit(statement);
     }
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitStructDefinition(struct AsgStructDefinition* node)
+LRValue TypeResolver::visitStructDefinition(AsgStructDefinition* node)
 {
     UPDATE_VIS(node, nodes_);
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitFunctionDefinition(struct AsgFunctionDefinition* node)
+LRValue TypeResolver::visitFunctionDefinition(AsgFunctionDefinition* node)
 {
+    TraceScope trace{"type resolution", node->name.str()};
     UPDATE_VIS(node, nodes_);
     for (auto i = 0; i < node->parameters.size(); i++) {
-        if (node->type->parameters[i]->as<StructType>()) {
+        auto paramType = types_.get(node->parameters[i].type);
+        if (paramType->as<StructType>()) {
             auto origName = node->parameters[i].name;
             auto origTypeStr = node->parameters[i].type;
+            auto origSlot = node->parameters[i].slot;
 
-            node->type->parameters[i] = node->type->parameters[i]->getRef();
-            node->parameters[i].type.push_back('*');
+            node->parameters[i].type.ptrDepth++;
             node->parameters[i].name = getTmpParamName(node->parameters[i].name);
+            node->parameters[i].slot = node->addSlot(paramType->getRef());
 
-            node->body->addLocalVar(node->parameters[i].name, node->type->parameters[i]);
+            if (!node->body) {
+                continue;
+            }
 
             auto defNode = std::make_unique<AsgVariableDefinition>();
             defNode->name = origName;
             defNode->type = origTypeStr;
+            defNode->slot = origSlot;
             defNode->list = (AsgStatementList*)node->body.get();
             defNode->function = node;
 
@@ -98,6 +114,7 @@ std::any TypeResolver::visitFunctionDefinition(struct AsgFunctionDefinition* nod
 
             auto varNode = std::make_unique<AsgVariable>();
             varNode->name = node->parameters[i].name;
+            varNode->slot = node->parameters[i].slot;
             varNode->list = (AsgStatementList*)node->body.get();
             varNode->function = node;
 
@@ -109,29 +126,40 @@ std::any TypeResolver::visitFunctionDefinition(struct AsgFunctionDefinition* nod
         }
     }
 
-    if (node->type->returnType->as<StructType>()) {
-        node->body->addLocalVar(getTmpRetName(node->name), node->type->returnType->getRef());
-
-        node->parameters.insert(node->parameters.begin(), {node->returnType, getTmpRetName(node->name)});
-        node->type->parameters.insert(node->type->parameters.begin(), node->type->returnType->getRef());
+    if (!node->type->lowered) {
+        for (auto& parameter : node->type->parameters) {
+            if (parameter->as<StructType>()) {
+                parameter = parameter->getRef();
+            }
+        }
+        if (node->type->returnType->as<StructType>()) {
+            node->type->parameters.insert(node->type->parameters.begin(), node->type->returnType->getRef());
+            node->type->origRetType = node->type->returnType;
+            node->type->returnType = types_.getVoid();
+        }
+        node->type->lowered = true;
+    }
 
-        node->type->origRetType = node->type->returnType;
+    if (node->type->origRetType) {
+        auto retSlot = node->addSlot(node->type->origRetType->getRef());
 
-        node->type->returnType = TypeLibrary::inst().get("void");
-        node->returnType = "void";
+        node->parameters.insert(node->parameters.begin(), {node->returnType, getTmpRetName(node->name), retSlot});
+        node->returnType = TypeRef{Identifier::get("void")};
     }
 
-    node->body->accept(this);
+    if (node->body) {
+        visit(node->body);
+    }
 
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitVariableDefinition(struct AsgVariableDefinition* node)
+LRValue TypeResolver::visitVariableDefinition(AsgVariableDefinition* node)
 {
     UPDATE_VIS(node, nodes_);
-    auto nodeType = TypeLibrary::inst().get(node->type);
+    auto nodeType = types_.get(node->type);
     if (node->value) {
-        auto valueType = std::any_cast<LRValue>(node->value->accept(this)).type;
+        auto valueType = visit(node->value).type;
         if (!Type::isSame(nodeType, valueType)) {
             if (nodeType && valueType) {
                 TC_LOG_ERROR(
@@ -146,14 +174,14 @@ std::any TypeResolver::visitVariableDefinition(struct AsgVariableDefinition* nod
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitReturn(struct AsgReturn* node)
+LRValue TypeResolver::visitReturn(AsgReturn* node)
 {
     UPDATE_VIS(node, nodes_);
     auto expected = node->function->type->returnType;
     if (node->function->type->origRetType) {
         expected = node->function->type->origRetType;
     }
-    auto real = std::any_cast<LRValue>(node->value->accept(this)).type;
+    auto real = visit(node->value).type;
     if (!Type::isSame(real, expected)) {
         if (real && expected) {
             TC_LOG_ERROR(
@@ -182,6 +210,7 @@ std::any TypeResolver::visitReturn(struct AsgReturn* node)
         var->function = node->function;
         var->exprType = node->function->type->origRetType->getRef();
         var->name = getTmpRetName(node->function->name);
+        var->slot = node->function->parameters.front().slot;
 
         assignable->expression = std::move(var);
         assignNode->assignable = std::move(assignable);
@@ -198,11 +227,11 @@ std::any TypeResolver::visitReturn(struct AsgReturn* node)
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitAssignment(struct AsgAssignment* node)
+LRValue TypeResolver::visitAssignment(AsgAssignment* node)
 {
     UPDATE_VIS(node, nodes_);
-    auto valueType = std::any_cast<LRValue>(node->value->accept(this));
-    auto assignableType = std::any_cast<LRValue>(node->assignable->accept(this));
+    auto valueType = visit(node->value);
+    auto assignableType = visit(node->assignable);
 
     if (assignableType.side == LRValue::Side::R) {
         TC_LOG_ERROR(
@@ -227,30 +256,30 @@ std::any TypeResolver::visitAssignment(struct AsgAssignment* node)
     return LRValue{valueType};
 }
 
-std::any TypeResolver::visitConditional(struct AsgConditional* node)
+LRValue TypeResolver::visitConditional(AsgConditional* node)
 {
     UPDATE_VIS(node, nodes_);
-    node->condition->accept(this);
-    node->thenNode->accept(this);
+    visit(node->condition);
+    visit(node->thenNode);
     if (node->elseNode) {
-        node->elseNode->accept(this);
+        visit(node->elseNode);
     }
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitLoop(struct AsgLoop* node)
+LRValue TypeResolver::visitLoop(AsgLoop* node)
 {
     UPDATE_VIS(node, nodes_);
-    node->condition->accept(this);
-    node->body->accept(this);
+    visit(node->condition);
+    visit(node->body);
     return LRValue{Type::invalid()};
 }
 
-std::any TypeResolver::visitComp(struct AsgComp* node)
+LRValue TypeResolver::visitComp(AsgComp* node)
 {
     UPDATE_VIS(node, nodes_);
-    auto lhsType = std::any_cast<LRValue>(node->lhs->accept(this)).type;
-    auto rhsType = std::any_cast<LRValue>(node->rhs->accept(this)).type;
+    auto lhsType = visit(node->lhs).type;
+    auto rhsType = visit(node->rhs).type;
     if (!Type::isSame(lhsType, rhsType)) {
         if (rhsType && lhsType) {
             TC_LOG_ERROR(
@@ -262,15 +291,15 @@ std::any TypeResolver::visitComp(struct AsgComp* node)
         ok_ = false;
         return LRValue{Type::invalid()};
     }
-    node->exprType = TypeLibrary::inst().get("int");
+    node->exprType = types_.getInt();
     return LRValue{node->exprType};
 }
 
-std::any TypeResolver::visitAddSub(struct AsgAddSub* node)
+LRValue TypeResolver::visitAddSub(AsgAddSub* node)
 {
     UPDATE_VIS(node, nodes_);
     for (auto& expr : node->subexpressions) {
-        if (auto t = std::any_cast<LRValue>(expr.expression->accept(this)).type; t != TypeLibrary::inst().get("int")) {
+        if (auto t = visit(expr.expression).type; t != types_.getInt()) {
             if (t) {
                 TC_LOG_ERROR("at line {} -- invalid arithmetic with type {}", node->refLine, t->toString());
             }
@@ -278,15 +307,15 @@ std::any TypeResolver::visitAddSub(struct AsgAddSub* node)
             return LRValue{Type::invalid()};
         }
     }
-    node->exprType = TypeLibrary::inst().get("int");
+    node->exprType = types_.getInt();
     return LRValue{node->exprType};
 }
 
-std::any TypeResolver::visitMulDiv(struct AsgMulDiv* node)
+LRValue TypeResolver::visitMulDiv(AsgMulDiv* node)
 {
     UPDATE_VIS(node, nodes_);
     for (auto& expr : node->subexpressions) {
-        if (auto t = std::any_cast<LRValue>(expr.expression->accept(this)).type; t != TypeLibrary::inst().get("int")) {
+        if (auto t = visit(expr.expression).type; t != types_.getInt()) {
             if (t) {
                 TC_LOG_ERROR("at line {} -- invalid arithmetic with type {}", node->refLine, t->toString());
             }
@@ -294,15 +323,15 @@ std::any TypeResolver::visitMulDiv(struct AsgMulDiv* node)
             return LRValue{Type::invalid()};
         }
     }
-    node->exprType = TypeLibrary::inst().get("int");
+    node->exprType = types_.getInt();
     return LRValue{node->exprType};
 }
 
-std::any TypeResolver::visitFieldAccess(struct AsgFieldAccess* node)
+LRValue TypeResolver::visitFieldAccess(AsgFieldAccess* node)
 {
     UPDATE_VIS(node, nodes_);
 
-    auto accessedT = std::any_cast<LRValue>(node->accessed->accept(this));
+    auto accessedT = visit(node->accessed);
 
     if (!accessedT.type) {
         return LRValue{Type::invalid()};
@@ -331,10 +360,10 @@ std::any TypeResolver::visitFieldAccess(struct AsgFieldAccess* node)
     return LRValue{node->exprType, accessedT.side};
 }
 
-std::any TypeResolver::visitIndexing(struct AsgIndexing* node)
+LRValue TypeResolver::visitIndexing(AsgIndexing* node)
 {
     UPDATE_VIS(node, nodes_);
-    auto indexedType = std::any_cast<LRValue>(node->indexed->accept(this)).type;
+    auto indexedType = visit(node->indexed).type;
     if (!indexedType || !indexedType->as<ArrayType>()) {
         if (indexedType) {
             TC_LOG_ERROR("at line {} -- invalid indexing of type {}", node->refLine, indexedType->toString());
@@ -343,8 +372,8 @@ std::any TypeResolver::visitIndexing(struct AsgIndexing* node)
         return LRValue{Type::invalid()};
     }
     for (auto& index : node->indexes) {
-        auto indexType = std::any_cast<LRValue>(index->accept(this)).type;
-        if (indexType != TypeLibrary::inst().get("int")) {
+        auto indexType = visit(index).type;
+        if (indexType != types_.getInt()) {
             if (indexType) {
                 TC_LOG_ERROR(
                     "at line {} -- invalid index type: expected: int, got: {}",
@@ -374,10 +403,10 @@ std::any TypeResolver::visitIndexing(struct AsgIndexing* node)
     return LRValue{indexedType, LRValue::Side::L};
 }
 
-std::any TypeResolver::visitOpDeref(struct AsgOpDeref* node)
+LRValue TypeResolver::visitOpDeref(AsgOpDeref* node)
 {
     UPDATE_VIS(node, nodes_);
-    auto t = std::any_cast<LRValue>(node->expression->accept(this)).type;
+    auto t = visit(node->expression).type;
 
     if (!t) {
         return LRValue{Type::invalid()};
@@ -401,10 +430,10 @@ std::any TypeResolver::visitOpDeref(struct AsgOpDeref* node)
     return LRValue{t, LRValue::Side::L};
 }
 
-std::any TypeResolver::visitOpRef(struct AsgOpRef* node)
+LRValue TypeResolver::visitOpRef(AsgOpRef* node)
 {
     UPDATE_VIS(node, nodes_);
-    auto t = std::any_cast<LRValue>(node->value->accept(this));
+    auto t = visit(node->value);
 
     if (!t.type) {
         return LRValue(Type::invalid());
@@ -423,21 +452,14 @@ std::any TypeResolver::visitOpRef(struct AsgOpRef* node)
     return LRValue{node->exprType};
 }
 
-std::any TypeResolver::visitVariable(struct AsgVariable* node)
+LRValue TypeResolver::visitVariable(AsgVariable* node)
 {
     UPDATE_VIS(node, nodes_);
-    const AsgStatementList* list = node->list;
-    while (list) {
-        if (list->localVariables.find(node->name) != list->localVariables.end()) {
-            node->exprType = list->localVariables.at(node->name);
-            return LRValue(node->exprType, LRValue::Side::L);
-        }
-        list = list->list;
-    }
-    return LRValue(Type::invalid());
+    node->exprType = node->function->slots[node->slot];
+    return LRValue(node->exprType, LRValue::Side::L);
 }
 
-std::any TypeResolver::visitCall(struct AsgCall* node)
+LRValue TypeResolver::visitCall(AsgCall* node)
 {
     UPDATE_VIS(node, nodes_);
 
@@ -457,7 +479,7 @@ std::any TypeResolver::visitCall(struct AsgCall* node)
     }
     for (auto i = 0; i < node->arguments.size(); i++) {
 
-        auto argT = std::any_cast<LRValue>(node->arguments[i]->accept(this)).type;
+        auto argT = visit(node->arguments[i]).type;
         auto realParamT = node->callee->parameters[node->callee->origRetType ? i + 1 : i];
 
         if (!argT) {
@@ -487,29 +509,30 @@ std::any TypeResolver::visitCall(struct AsgCall* node)
             refNode->function = node->function;
             refNode->value = std::move(node->arguments[i]);
             node->arguments[i] = std::move(refNode);
-            node->arguments[i]->accept(this);
+            visit(node->arguments[i]);
         }
     }
 
     if (node->callee->origRetType) {
         nodes_.pop_back();
 
-        auto tmpName = "." + std::to_string(next_unique_tmp_++) + "_ret_val";
+        auto tmpName = Identifier::get("." + std::to_string(next_unique_tmp_++) + "_ret_val");
+        auto tmpSlot = node->function->addSlot(node->callee->origRetType);
         auto declNode = std::make_unique<AsgVariableDefinition>();
         declNode->list = node->list;
         declNode->function = node->function;
-        declNode->type = node->callee->origRetType->toString();
+        declNode->type = TypeRef{Identifier::get(node->callee->origRetType->toString())};
         declNode->name = tmpName;
+        declNode->slot = tmpSlot;
         node->list->statements.insert(node->list->statements.begin(), std::move(declNode));
 
-        node->addLocalVar(tmpName, node->callee->origRetType);
-
         {
             auto varNode = std::make_unique<AsgVariable>();
             varNode->list = node->list;
             varNode->function = node->function;
             varNode->exprType = node->callee->origRetType;
             varNode->name = tmpName;
+            varNode->slot = tmpSlot;
 
             nodes_.back()->updateChild(node, varNode.release());
         }
@@ -525,6 +548,7 @@ std::any TypeResolver::visitCall(struct AsgCall* node)
             varNode->function = node->function;
             varNode->exprType = node->callee->origRetType;
             varNode->name = tmpName;
+            varNode->slot = tmpSlot;
             refOp->value = std::move(varNode);
         }
 
@@ -551,9 +575,9 @@ std::any TypeResolver::visitCall(struct AsgCall* node)
     return LRValue{node->exprType};
 }
 
-std::any TypeResolver::visitIntLiteral(struct AsgIntLiteral* node)
+LRValue TypeResolver::visitIntLiteral(AsgIntLiteral* node)
 {
     UPDATE_VIS(node, nodes_);
-    node->exprType = TypeLibrary::inst().get("int");
+    node->exprType = types_.getInt();
     return LRValue{node->exprType};
 }
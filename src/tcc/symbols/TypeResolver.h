@@ -1,34 +1,41 @@
 #ifndef TINYC_TYPERESOLVER_H
 #define TINYC_TYPERESOLVER_H
 
-#include "asg/AsgNode.h"
 #include "asg/AsgVisitor.h"
 #include "pipeline/PipelineStage.h"
+#include "TypeLib.h"
 
-class TypeResolver : private AsgVisitorBase,
+class TypeResolver : private AsgVisitor<TypeResolver, LRValue>,
                      public PipeModifierBase {
 public:
+    explicit TypeResolver(TypeLibrary& types);
+
     std::any modify(std::any data) override;
+    std::string_view getName() const override;
 
 private:
-    std::any visitStatementList(struct AsgStatementList* node) override;
-    std::any visitStructDefinition(struct AsgStructDefinition* node) override;
-    std::any visitFunctionDefinition(struct AsgFunctionDefinition* node) override;
-    std::any visitVariableDefinition(struct AsgVariableDefinition* node) override;
-    std::any visitReturn(struct AsgReturn* node) override;
-    std::any visitAssignment(struct AsgAssignment* node) override;
-    std::any visitConditional(struct AsgConditional* node) override;
-    std::any visitLoop(struct AsgLoop* node) override;
-    std::any visitComp(struct AsgComp* node) override;
-    std::any visitAddSub(struct AsgAddSub* node) override;
-    std::any visitMulDiv(struct AsgMulDiv* node) override;
-    std::any visitFieldAccess(struct AsgFieldAccess* node) override;
-    std::any visitIndexing(struct AsgIndexing* node) override;
-    std::any visitOpDeref(struct AsgOpDeref* node) override;
-    std::any visitOpRef(struct AsgOpRef* node) override;
-    std::any visitVariable(struct AsgVariable* node) override;
-    std::any visitCall(struct AsgCall* node) override;
-    std::any visitIntLiteral(struct AsgIntLiteral* node) override;
+    friend class AsgVisitor<TypeResolver, LRValue>;
+
+    LRValue visitStatementList(AsgStatementList* node);
+    LRValue visitStructDefinition(AsgStructDefinition* node);
+    LRValue visitFunctionDefinition(AsgFunctionDefinition* node);
+    LRValue visitVariableDefinition(AsgVariableDefinition* node);
+    LRValue visitReturn(AsgReturn* node);
+    LRValue visitAssignment(AsgAssignment* node);
+    LRValue visitConditional(AsgConditional* node);
+    LRValue visitLoop(AsgLoop* node);
+    LRValue visitComp(AsgComp* node);
+    LRValue visitAddSub(AsgAddSub* node);
+    LRValue visitMulDiv(AsgMulDiv* node);
+    LRValue visitFieldAccess(AsgFieldAccess* node);
+    LRValue visitIndexing(AsgIndexing* node);
+    LRValue visitOpDeref(AsgOpDeref* node);
+    LRValue visitOpRef(AsgOpRef* node);
+    LRValue visitVariable(AsgVariable* node);
+    LRValue visitCall(AsgCall* node);
+    LRValue visitIntLiteral(AsgIntLiteral* node);
+
+    TypeLibrary& types_;
 
     bool ok_ = true;
     int next_unique_tmp_ = 0;
@@ -0,0 +1,30 @@
+#ifndef TINYC_PARALLEL_H
+#define TINYC_PARALLEL_H
+
+template<typename F>
+void parallelFor(size_t count, size_t jobs, F&& f)
+{
+    jobs = std::min(jobs, count);
+    if (jobs <= 1) {
+        for (size_t i = 0; i < count; i++) {
+            f(i);
+        }
+        return;
+    }
+
+    std::atomic<size_t> next{0};
+    std::vector<std::thread> workers;
+    workers.reserve(jobs);
+    for (size_t j = 0; j < jobs; j++) {
+        workers.emplace_back([&]() {
+            for (auto i = next++; i < count; i = next++) {
+                f(i);
+            }
+        });
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+}
+
+#endif
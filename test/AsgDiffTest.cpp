@@ -0,0 +1,448 @@
+#include "asg/AsgArena.h"
+#include "asg/AsgNode.h"
+#include "asg/AsgVisitor.h"
+#include "ast/AstVisitor.h"
+#include "lexer/FastLexer.h"
+#include "pipeline/input/FileReader.h"
+#include "pipeline/input/SourceParser.h"
+
+// Builds the ASG of every example, of the declaration/expression ambiguities and of a generated source large enough
+// to be parsed in parallel: with TinyCLexer and AstVisitor, with FastLexer and AstVisitor, and with --parser=rd on one
+// and on several threads. All dumps have to be equal. A parallel parse in which one range fails must fail as a whole
+// and free the trees of the other ranges.
+//
+// usage: asg_diff_test <examples directory>
+
+// live heap allocations of the process, to check that a failed parse frees everything it built
+static std::atomic<long> live_allocations{0};
+
+void* operator new(size_t size)
+{
+    if (auto* ptr = std::malloc(size != 0 ? size : 1)) {
+        live_allocations++;
+        return ptr;
+    }
+    throw std::bad_alloc{};
+}
+
+void operator delete(void* ptr) noexcept
+{
+    if (ptr) {
+        live_allocations--;
+        std::free(ptr);
+    }
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    operator delete(ptr);
+}
+
+// the statements are parsed as: expression, expression, declaration, declaration
+static constexpr std::string_view ambiguity_cases[] = {
+        "a * b;",
+        "a * b[3];",
+        "a * b[];",
+        "a * b = 1;",
+};
+
+static constexpr size_t parallel_jobs = 4;
+
+// SourceParser splits the tokens into at most one range per 8192 tokens
+static constexpr size_t min_parallel_tokens = parallel_jobs * 8192;
+
+static constexpr std::string_view comp_operators[] = {"==", "!=", "<", "<=", ">", ">="};
+
+// one node per line, children indented below their parent
+//
+// line numbers are left out where the front ends are documented to differ: AstVisitor sets none for loops,
+// for the statement lists it makes for 'for' and for the root list
+class AsgDumper : private AsgVisitor<AsgDumper, void> {
+public:
+    std::string dump(AsgNode* root)
+    {
+        visit(root);
+        return out_.str();
+    }
+
+private:
+    friend class AsgVisitor<AsgDumper, void>;
+
+    void visitStatementList(AsgStatementList* node)
+    {
+        // 'for' becomes {init; Loop} with the loop body {statement; step}
+        auto forList = node->statements.size() == 2 && node->statements[1]->kind == AsgNode::Kind::Loop;
+        auto withLine = depth_ != 0 && !loop_body_ && !forList;
+        loop_body_ = false;
+
+        print(withLine ? node : nullptr, "StatementList");
+        for (auto& statement : node->statements) {
+            child(statement);
+        }
+    }
+
+    void visitStructDefinition(AsgStructDefinition* node)
+    {
+        print(node, fmt::format("StructDefinition {}", node->name));
+        depth_++;
+        for (auto& field : node->fields) {
+            out_ << fmt::format("{:{}}Field line {} {} {}\n", "", depth_ * 2, field.refLine, field.type.toString(), field.name);
+        }
+        depth_--;
+    }
+
+    void visitFunctionDefinition(AsgFunctionDefinition* node)
+    {
+        print(node, fmt::format("FunctionDefinition {} {}", node->returnType.toString(), node->name));
+        depth_++;
+        for (auto& parameter : node->parameters) {
+            out_ << fmt::format("{:{}}Parameter {} {}\n", "", depth_ * 2, parameter.type.toString(), parameter.name);
+        }
+        depth_--;
+        if (node->body) {
+            child(node->body);
+        }
+    }
+
+    void visitVariableDefinition(AsgVariableDefinition* node)
+    {
+        print(node, fmt::format("VariableDefinition {} {}", node->type.toString(), node->name));
+        if (node->value) {
+            child(node->value);
+        }
+    }
+
+    void visitReturn(AsgReturn* node)
+    {
+        print(node, "Return");
+        if (node->value) {
+            child(node->value);
+        }
+    }
+
+    void visitAssignment(AsgAssignment* node)
+    {
+        print(node, "Assignment");
+        child(node->assignable);
+        child(node->value);
+    }
+
+    void visitConditional(AsgConditional* node)
+    {
+        print(node, node->elseNode ? "Conditional with else" : "Conditional");
+        child(node->condition);
+        child(node->thenNode);
+        if (node->elseNode) {
+            child(node->elseNode);
+        }
+    }
+
+    void visitLoop(AsgLoop* node)
+    {
+        print(nullptr, "Loop");
+        child(node->condition);
+        loop_body_ = node->body->kind == AsgNode::Kind::StatementList;
+        child(node->body);
+    }
+
+    void visitComp(AsgComp* node)
+    {
+        print(node, fmt::format("Comp {}", comp_operators[static_cast<size_t>(node->op)]));
+        child(node->lhs);
+        child(node->rhs);
+    }
+
+    void visitAddSub(AsgAddSub* node)
+    {
+        std::string ops;
+        for (auto& subexpression : node->subexpressions) {
+            ops += subexpression.leadingOp == AsgAddSub::Operator::Add ? " +" : " -";
+        }
+        print(node, "AddSub" + ops);
+        for (auto& subexpression : node->subexpressions) {
+            child(subexpression.expression);
+        }
+    }
+
+    void visitMulDiv(AsgMulDiv* node)
+    {
+        std::string ops;
+        for (auto& subexpression : node->subexpressions) {
+            ops += subexpression.leadingOp == AsgMulDiv::Operator::Mul ? " *" : " /";
+        }
+        print(node, "MulDiv" + ops);
+        for (auto& subexpression : node->subexpressions) {
+            child(subexpression.expression);
+        }
+    }
+
+    void visitFieldAccess(AsgFieldAccess* node)
+    {
+        print(node, fmt::format("FieldAccess {}", node->field));
+        child(node->accessed);
+    }
+
+    void visitIndexing(AsgIndexing* node)
+    {
+        print(node, "Indexing");
+        child(node->indexed);
+        for (auto& index : node->indexes) {
+            child(index);
+        }
+    }
+
+    void visitOpDeref(AsgOpDeref* node)
+    {
+        print(node, fmt::format("OpDeref {}", node->derefCount));
+        child(node->expression);
+    }
+
+    void visitOpRef(AsgOpRef* node)
+    {
+        print(node, "OpRef");
+        child(node->value);
+    }
+
+    void visitVariable(AsgVariable* node)
+    {
+        print(node, fmt::format("Variable {}", node->name));
+    }
+
+    void visitCall(AsgCall* node)
+    {
+        print(node, fmt::format("Call {}", node->functionName));
+        for (auto& argument : node->arguments) {
+            child(argument);
+        }
+    }
+
+    void visitIntLiteral(AsgIntLiteral* node)
+    {
+        print(node, fmt::format("IntLiteral {}", node->value));
+    }
+
+    // the line is printed only for a non null node
+    void print(AsgNode* node, std::string_view text)
+    {
+        out_ << fmt::format("{:{}}{}", "", depth_ * 2, text);
+        if (node) {
+            out_ << " line " << node->refLine;
+        }
+        out_ << '\n';
+    }
+
+    void child(const std::unique_ptr<AsgNode>& node)
+    {
+        depth_++;
+        if (node) {
+            visit(node);
+        } else {
+            print(nullptr, "<null>");
+        }
+        depth_--;
+    }
+
+    std::ostringstream out_;
+    size_t depth_ = 0;
+    bool loop_body_ = false;
+};
+
+// every tree is built in its own arena, so the front ends never share interned identifiers
+static std::optional<std::string> buildAndDump(const std::function<std::any()>& build)
+{
+    AsgArena arena;
+    AsgArena::Scope arenaScope{arena};
+
+    auto root = build();
+    if (!root.has_value()) {
+        return std::nullopt;
+    }
+    std::unique_ptr<AsgNode> tree{std::any_cast<AsgNode*>(root)};
+    return AsgDumper{}.dump(tree.get());
+}
+
+// structs, prototypes and functions calling functions defined far away, so calls and types cross the parallel ranges;
+// a broken source has a syntax error in a function in the middle
+static std::string generateLargeSource(size_t functions, bool broken)
+{
+    static constexpr size_t structs = 16;
+
+    std::string source;
+    for (size_t i = 0; i < structs; i++) {
+        source += fmt::format("struct Pair{0} {{ int first; int second[4]; struct Pair{0}* next; }};\n", i);
+    }
+    for (size_t i = 0; i < functions; i++) {
+        source += fmt::format("int function{}(struct Pair{}* pair, int depth);\n", i, i % structs);
+    }
+    for (size_t i = 0; i < functions; i++) {
+        source += fmt::format(
+                "\nint function{0}(struct Pair{1}* pair, int depth)\n"
+                "{{\n"
+                "    int sum = pair->first + pair->second[{2}];\n"
+                "    if (depth > 0) {{\n"
+                "        sum = sum + function{3}(pair->next, depth - 1) * function{4}(pair, depth / 2);\n"
+                "    }}\n"
+                "    while (sum > 100) sum = sum / 2;\n"
+                "    return {5};\n"
+                "}}\n",
+                i, i % structs, i % 4, (i + functions / 2) % functions, functions - 1 - i,
+                broken && i == functions / 2 ? "sum +" : "sum");
+    }
+    return source;
+}
+
+static bool writeTemporary(const std::string& source, std::vector<std::string>& files, std::vector<std::unique_ptr<llvm::FileRemover>>& removers)
+{
+    int fd;
+    llvm::SmallString<128> path;
+    if (auto ec = llvm::sys::fs::createTemporaryFile("asg_diff", "c", fd, path)) {
+        TC_LOG_CRITICAL("can not create temporary file -- {}", ec.message());
+        return false;
+    }
+    removers.push_back(std::make_unique<llvm::FileRemover>(path));
+
+    llvm::raw_fd_ostream stream{fd, true};
+    stream << source;
+    files.emplace_back(path.str());
+    return true;
+}
+
+static std::any parseWithAntlr(const std::string& file, bool fastLexer)
+{
+    auto unit = FileReader{file, fastLexer}.produce();
+    if (!unit.has_value()) {
+        return {};
+    }
+    return AstVisitor{}.modify(std::move(unit));
+}
+
+static void reportDifference(const std::string& file, std::string_view frontEnd, llvm::StringRef expected, llvm::StringRef actual)
+{
+    size_t line = 1;
+    while (!expected.empty() || !actual.empty()) {
+        auto [expectedLine, expectedRest] = expected.split('\n');
+        auto [actualLine, actualRest] = actual.split('\n');
+        if (expectedLine != actualLine) {
+            TC_LOG_ERROR("{} -- {} differs at dump line {}\n  ANTLR: {}\n  {}: {}", file, frontEnd, line, expectedLine, frontEnd, actualLine);
+            return;
+        }
+        expected = expectedRest;
+        actual = actualRest;
+        line++;
+    }
+}
+
+static bool compareFrontEnds(const std::string& file)
+{
+    auto expected = buildAndDump([&] { return parseWithAntlr(file, false); });
+    if (!expected) {
+        TC_LOG_ERROR("{} -- ANTLR front end failed", file);
+        return false;
+    }
+
+    std::pair<std::string_view, std::optional<std::string>> dumps[] = {
+            {"FastLexer", buildAndDump([&] { return parseWithAntlr(file, true); })},
+            {"--parser=rd", buildAndDump([&] { return SourceParser{file, 1}.produce(); })},
+            {"--parser=rd --parse-jobs=4", buildAndDump([&] { return SourceParser{file, parallel_jobs}.produce(); })},
+    };
+
+    auto ok = true;
+    for (auto& [frontEnd, dump] : dumps) {
+        if (!dump) {
+            TC_LOG_ERROR("{} -- {} front end failed", file, frontEnd);
+            ok = false;
+        } else if (*dump != *expected) {
+            reportDifference(file, frontEnd, *expected, *dump);
+            ok = false;
+        }
+    }
+    return ok;
+}
+
+static bool checkFailedParallelParse(const std::string& file)
+{
+    auto parse = [&] {
+        AsgArena arena;
+        AsgArena::Scope arenaScope{arena};
+        return SourceParser{file, parallel_jobs}.produce();
+    };
+
+    // the first run also makes what is allocated once per process, e.g. by the logger
+    if (parse().has_value()) {
+        TC_LOG_ERROR("{} -- the parallel parse of a broken source succeeded", file);
+        return false;
+    }
+
+    auto before = live_allocations.load();
+    TC_UNUSED(parse());
+    auto leaked = live_allocations.load() - before;
+    if (leaked != 0) {
+        TC_LOG_ERROR("{} -- the failed parallel parse leaked {} allocations", file, leaked);
+        return false;
+    }
+    return true;
+}
+
+int main(int argc, char** argv)
+{
+    logInit();
+
+    if (argc != 2) {
+        TC_LOG_CRITICAL("usage: asg_diff_test <examples directory>");
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> files;
+    std::error_code error;
+    for (llvm::sys::fs::recursive_directory_iterator it{argv[1], error}, end; it != end && !error; it.increment(error)) {
+        if (llvm::sys::path::extension(it->path()) == ".c") {
+            files.push_back(it->path());
+        }
+    }
+    if (error || files.empty()) {
+        TC_LOG_CRITICAL("no examples found in {} -- {}", argv[1], error.message());
+        return EXIT_FAILURE;
+    }
+    std::sort(files.begin(), files.end());
+
+    std::vector<std::unique_ptr<llvm::FileRemover>> removers;
+    for (auto statement : ambiguity_cases) {
+        auto source = fmt::format("int ambiguity(int a, int b)\n{{\n    {}\n    return 0;\n}}\n", statement);
+        if (!writeTemporary(source, files, removers)) {
+            return EXIT_FAILURE;
+        }
+    }
+
+    static constexpr size_t large_functions = 640;
+    auto large = generateLargeSource(large_functions, false);
+    if (FastLexer{large}.tokenize().size() < min_parallel_tokens) {
+        TC_LOG_CRITICAL("the generated source is too small to be parsed in {} ranges", parallel_jobs);
+        return EXIT_FAILURE;
+    }
+    if (!writeTemporary(large, files, removers)) {
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> brokenFiles;
+    if (!writeTemporary(generateLargeSource(large_functions, true), brokenFiles, removers)) {
+        return EXIT_FAILURE;
+    }
+
+    size_t failures = 0;
+    for (auto& file : files) {
+        if (!compareFrontEnds(file)) {
+            failures++;
+        }
+    }
+
+    if (!checkFailedParallelParse(brokenFiles.front())) {
+        failures++;
+    }
+
+    if (failures != 0) {
+        TC_LOG_ERROR("{} of {} checks failed", failures, files.size() + 1);
+        return EXIT_FAILURE;
+    }
+    std::cout << fmt::format("{} inputs, all front ends agree\n", files.size());
+    return EXIT_SUCCESS;
+}